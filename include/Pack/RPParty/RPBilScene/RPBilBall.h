@@ -3,6 +3,8 @@
 #include "RPTypes.h"
 #include <RPUtility/RPUtlBaseFsm.h>
 
+#include <egg/math/eggVector.h>
+
 class RPBilBall {
 public:
     enum EState { EState_Null, EState_Wait, EState_Pocket, EState_OffTable };
@@ -19,9 +21,29 @@ public:
         mStateMachine->ChangeState(state);
     }
 
+    const EGG::Vector3f& GetPosition() const {
+        return mPosition;
+    }
+
+    const EGG::Vector3f& GetVelocity() const {
+        return mVelocity;
+    }
+
+    RPUtlBaseFsm<RPBilBall>* GetStateMachine() const {
+        return mStateMachine;
+    }
+
 private:
-    // RPPartyGameObjBase -> IRPSysHostIOSocket, etc.
-    char _00[0x60];
+    // Same 0x60-byte base as RPBilCue (RPPartyUtlModel): its own members
+    // start at 0x60, and the position/velocity below are the ones mapped in
+    // RPPartyUtlModel.h. Not yet checked against a disassembly of the ball
+    // code, so the validation modes of the pruner and settle detector (which
+    // read them) should be run before relying on either.
+    char _00[0x10];
+
+    EGG::Vector3f mPosition; // at 0x10
+    EGG::Vector3f mVelocity; // at 0x1C
+    char _28[0x60 - 0x28];
 
     u32 mId;                                // at 0x60
     RPUtlBaseFsm<RPBilBall>* mStateMachine; // at 0x64
@@ -47,6 +47,10 @@ public:
         mValidAim = true;
     }
 
+    RPUtlBaseFsm<RPBilCue>* GetStateMachine() const {
+        return mpStateMachine;
+    }
+
 private:
     char _60[0x8];
     RPUtlBaseFsm<RPBilCue>* mpStateMachine; // at 0x68
@@ -13,6 +13,10 @@ public:
     void Calculate();
     void Reset();
 
+    RPUtlBaseFsm<RPBilMain>* GetStateMachine() const {
+        return mpStateMachine;
+    }
+
 private:
     RPUtlBaseFsm<RPBilMain>* mpStateMachine; // at 0x4
 };
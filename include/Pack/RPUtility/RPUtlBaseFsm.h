@@ -98,6 +98,15 @@ public:
         return false;
     }
 
+    /**
+     * @brief Check for a pending state change
+     * @note Calculate only clears the enter flag, so the exit flag stays set
+     * after the first state change
+     */
+    bool IsChangingState() const {
+        return mDoEnter;
+    }
+
 private:
     /**
      * @brief Enter the current state
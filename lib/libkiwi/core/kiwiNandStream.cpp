@@ -1,5 +1,7 @@
 #include <libkiwi.h>
 
+#include <cstdio>
+
 namespace kiwi {
 
 /**
@@ -151,4 +153,251 @@ s32 NandStream::PeekImpl(void* pDst, u32 size) {
     return n;
 }
 
+/**
+ * @brief Opens stream to NAND file asynchronously
+ * @note Unlike Open, this does not create missing files
+ *
+ * @param rPath File path
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether the operation was started
+ */
+bool NandStream::OpenAsync(const String& rPath, AsyncCallback pCallback,
+                           void* pArg) {
+    NANDAccessType type;
+
+    K_ASSERT_EX(!IsOpen(), "Close the stream first");
+
+    // Convert open mode for NAND
+    switch (mOpenMode) {
+    case EOpenMode_Read:  type = NAND_ACCESS_READ; break;
+    case EOpenMode_Write: type = NAND_ACCESS_WRITE; break;
+    case EOpenMode_RW:    type = NAND_ACCESS_RW; break;
+    default:              K_ASSERT(false); break;
+    }
+
+    if (!BeginAsync(EAsyncOp_Open, pCallback, pArg)) {
+        return false;
+    }
+
+    s32 result = NANDOpenAsync(rPath, &mFileInfo, type, AsyncCallbackFunc,
+                               &mCommandBlock);
+
+    if (result != NAND_RESULT_OK) {
+        mAsyncOp = EAsyncOp_None;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Creates a NAND file asynchronously
+ *
+ * @param rPath File path (relative to the title's home directory)
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether the operation was started
+ */
+bool NandStream::CreateAsync(const String& rPath, AsyncCallback pCallback,
+                             void* pArg) {
+#if defined(PACK_RESORT)
+    K_ASSERT_EX(false, "Not implemented.");
+    return false;
+#else
+    if (!BeginAsync(EAsyncOp_Create, pCallback, pArg)) {
+        return false;
+    }
+
+    // Only the private API is asynchronous, and it needs an absolute path
+    char homeDir[FS_MAX_PATH];
+    s32 result = NANDGetHomeDir(homeDir);
+
+    if (result == NAND_RESULT_OK) {
+        std::snprintf(mAsyncPath, sizeof(mAsyncPath), "%s/%s", homeDir,
+                      rPath.CStr());
+
+        result = NANDPrivateCreateAsync(mAsyncPath, NAND_PERM_RWALL, 0,
+                                        AsyncCallbackFunc, &mCommandBlock);
+    }
+
+    if (result != NAND_RESULT_OK) {
+        mAsyncOp = EAsyncOp_None;
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+/**
+ * @brief Advances this stream's position asynchronously
+ *
+ * @param dir Seek direction
+ * @param offset Seek offset
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether the operation was started
+ */
+bool NandStream::SeekAsync(ESeekDir dir, s32 offset, AsyncCallback pCallback,
+                           void* pArg) {
+    NANDSeekMode mode;
+
+    K_ASSERT_EX(IsOpen(), "Stream is not available");
+
+    // Convert seekdir for NAND
+    switch (dir) {
+    case ESeekDir_Begin:   mode = NAND_SEEK_BEG; break;
+    case ESeekDir_Current: mode = NAND_SEEK_CUR; break;
+    case ESeekDir_End:     mode = NAND_SEEK_END; break;
+    default:               K_ASSERT(false); break;
+    }
+
+    if (!BeginAsync(EAsyncOp_Seek, pCallback, pArg)) {
+        return false;
+    }
+
+    s32 result = NANDSeekAsync(&mFileInfo, offset, mode, AsyncCallbackFunc,
+                               &mCommandBlock);
+
+    if (result != NAND_RESULT_OK) {
+        mAsyncOp = EAsyncOp_None;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes data to this stream asynchronously
+ *
+ * @param pSrc Source buffer (must stay valid until completion)
+ * @param size Number of bytes to write
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether the operation was started
+ */
+bool NandStream::WriteAsync(const void* pSrc, u32 size,
+                            AsyncCallback pCallback, void* pArg) {
+#if defined(PACK_RESORT)
+    K_ASSERT_EX(false, "Not implemented.");
+    return false;
+#else
+    K_ASSERT(pSrc != nullptr);
+    K_ASSERT_EX(IsOpen(), "Stream is not available");
+
+    K_ASSERT_EX(IsBufferAlign(pSrc), "Buffer must be aligned to %d bytes",
+                GetBufferAlign());
+
+    K_ASSERT_EX(IsSizeAlign(size),
+                "This stream type requires sizes aligned to %d bytes",
+                GetSizeAlign());
+
+    if (!BeginAsync(EAsyncOp_Write, pCallback, pArg)) {
+        return false;
+    }
+
+    s32 result = NANDWriteAsync(&mFileInfo, pSrc, size, AsyncCallbackFunc,
+                                &mCommandBlock);
+
+    if (result != NAND_RESULT_OK) {
+        mAsyncOp = EAsyncOp_None;
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+/**
+ * @brief Closes this stream asynchronously
+ *
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether the operation was started
+ */
+bool NandStream::CloseAsync(AsyncCallback pCallback, void* pArg) {
+    K_ASSERT_EX(IsOpen(), "Stream is not available");
+
+    if (!BeginAsync(EAsyncOp_Close, pCallback, pArg)) {
+        return false;
+    }
+
+    s32 result = NANDCloseAsync(&mFileInfo, AsyncCallbackFunc, &mCommandBlock);
+
+    if (result != NAND_RESULT_OK) {
+        mAsyncOp = EAsyncOp_None;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Prepares the command block for an asynchronous operation
+ *
+ * @param op Operation type
+ * @param pCallback Completion callback
+ * @param pArg Callback user argument
+ * @return Whether no other operation is in progress
+ */
+bool NandStream::BeginAsync(EAsyncOp op, AsyncCallback pCallback, void* pArg) {
+    K_ASSERT(pCallback != nullptr);
+
+    if (IsBusy()) {
+        K_LOG("Another NAND operation is in progress\n");
+        return false;
+    }
+
+    mAsyncOp = op;
+    mpAsyncCallback = pCallback;
+    mpAsyncCallbackArg = pArg;
+
+    // Not every game links NANDSetUserData
+    mCommandBlock.userData = this;
+
+    return true;
+}
+
+/**
+ * @brief Handles the completion of an asynchronous operation
+ *
+ * @param result NAND result code
+ * @param pBlock NAND command block
+ */
+void NandStream::AsyncCallbackFunc(s32 result, NANDCommandBlock* pBlock) {
+    K_ASSERT(pBlock != nullptr);
+
+    NandStream* p = static_cast<NandStream*>(pBlock->userData);
+    K_ASSERT(p != nullptr);
+
+    switch (p->mAsyncOp) {
+    case EAsyncOp_Open: {
+        p->mIsOpen = result == NAND_RESULT_OK;
+        break;
+    }
+
+    case EAsyncOp_Write: {
+        if (result > 0) {
+            p->mPosition += result;
+        }
+        break;
+    }
+
+    case EAsyncOp_Close: {
+        // Handle is released even if closing failed
+        p->mIsOpen = false;
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+
+    // Callback may start the next operation
+    p->mAsyncOp = EAsyncOp_None;
+    p->mpAsyncCallback(result, p->mpAsyncCallbackArg);
+}
+
 } // namespace kiwi
@@ -12,13 +12,26 @@ namespace kiwi {
  * @brief NAND file stream
  */
 class NandStream : public FileStream {
+public:
+    /**
+     * @brief Asynchronous operation callback
+     *
+     * @param result NAND result code, or number of bytes written
+     * @param pArg Callback user argument
+     */
+    typedef void (*AsyncCallback)(s32 result, void* pArg);
+
 public:
     /**
      * @brief Constructor
      *
      * @param mode Open mode
      */
-    explicit NandStream(EOpenMode mode) : FileStream(mode) {}
+    explicit NandStream(EOpenMode mode)
+        : FileStream(mode),
+          mpAsyncCallback(nullptr),
+          mpAsyncCallbackArg(nullptr),
+          mAsyncOp(EAsyncOp_None) {}
 
     /**
      * @brief Constructor
@@ -26,7 +39,11 @@ public:
      * @param rPath File path
      * @param mode Open mode
      */
-    NandStream(const String& rPath, EOpenMode mode) : FileStream(mode) {
+    NandStream(const String& rPath, EOpenMode mode)
+        : FileStream(mode),
+          mpAsyncCallback(nullptr),
+          mpAsyncCallbackArg(nullptr),
+          mAsyncOp(EAsyncOp_None) {
         Open(rPath);
     }
 
@@ -50,6 +67,72 @@ public:
      */
     virtual void Close();
 
+    /**
+     * @name Asynchronous operations
+     * @details Only one operation may be in progress at a time. The callback
+     * runs in the NAND interrupt context.
+     */
+    /**@{*/
+    /**
+     * @brief Opens stream to NAND file asynchronously
+     * @note Unlike Open, this does not create missing files
+     *
+     * @param rPath File path
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether the operation was started
+     */
+    bool OpenAsync(const String& rPath, AsyncCallback pCallback,
+                   void* pArg = nullptr);
+    /**
+     * @brief Creates a NAND file asynchronously
+     *
+     * @param rPath File path (relative to the title's home directory)
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether the operation was started
+     */
+    bool CreateAsync(const String& rPath, AsyncCallback pCallback,
+                     void* pArg = nullptr);
+    /**
+     * @brief Advances this stream's position asynchronously
+     *
+     * @param dir Seek direction
+     * @param offset Seek offset
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether the operation was started
+     */
+    bool SeekAsync(ESeekDir dir, s32 offset, AsyncCallback pCallback,
+                   void* pArg = nullptr);
+    /**
+     * @brief Writes data to this stream asynchronously
+     *
+     * @param pSrc Source buffer (must stay valid until completion)
+     * @param size Number of bytes to write
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether the operation was started
+     */
+    bool WriteAsync(const void* pSrc, u32 size, AsyncCallback pCallback,
+                    void* pArg = nullptr);
+    /**
+     * @brief Closes this stream asynchronously
+     *
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether the operation was started
+     */
+    bool CloseAsync(AsyncCallback pCallback, void* pArg = nullptr);
+
+    /**
+     * @brief Tests whether an asynchronous operation is in progress
+     */
+    bool IsBusy() const {
+        return mAsyncOp != EAsyncOp_None;
+    }
+    /**@}*/
+
     /**
      * @brief Gets the size of the currently open file
      */
@@ -93,6 +176,19 @@ public:
         return 32;
     }
 
+private:
+    /**
+     * @brief Asynchronous operation type
+     */
+    enum EAsyncOp {
+        EAsyncOp_None,
+        EAsyncOp_Open,
+        EAsyncOp_Create,
+        EAsyncOp_Seek,
+        EAsyncOp_Write,
+        EAsyncOp_Close
+    };
+
 private:
     /**
      * @brief Advances this stream's position (internal implementation)
@@ -130,8 +226,31 @@ private:
      */
     virtual s32 PeekImpl(void* pDst, u32 size);
 
+    /**
+     * @brief Prepares the command block for an asynchronous operation
+     *
+     * @param op Operation type
+     * @param pCallback Completion callback
+     * @param pArg Callback user argument
+     * @return Whether no other operation is in progress
+     */
+    bool BeginAsync(EAsyncOp op, AsyncCallback pCallback, void* pArg);
+    /**
+     * @brief Handles the completion of an asynchronous operation
+     *
+     * @param result NAND result code
+     * @param pBlock NAND command block
+     */
+    static void AsyncCallbackFunc(s32 result, NANDCommandBlock* pBlock);
+
 private:
     NANDFileInfo mFileInfo; //!< NAND file handle
+
+    NANDCommandBlock mCommandBlock; //!< Asynchronous command block
+    AsyncCallback mpAsyncCallback;  //!< Asynchronous completion callback
+    void* mpAsyncCallbackArg;       //!< Callback user argument
+    EAsyncOp mAsyncOp;              //!< Operation in progress
+    char mAsyncPath[FS_MAX_PATH];   //!< Absolute path for creation
 };
 
 //! @}
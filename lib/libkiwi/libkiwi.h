@@ -69,6 +69,7 @@
 #include <libkiwi/util/kiwiIosObject.h>
 #include <libkiwi/util/kiwiIosVector.h>
 #include <libkiwi/util/kiwiNonCopyable.h>
+#include <libkiwi/util/kiwiPcgRandom.h>
 #include <libkiwi/util/kiwiPtrUtil.h>
 #include <libkiwi/util/kiwiRandom.h>
 #include <libkiwi/util/kiwiStaticSingleton.h>
@@ -196,6 +196,9 @@ void HttpRequest::SendImpl() {
             mResponse.exError = LibSO::GetLastError();
             break;
         }
+
+        // Let other threads run while the connection is pending
+        OSSleepTicks(OS_MSEC_TO_TICKS(CONNECT_WAIT));
     }
 
     // Dispatch user callback
@@ -225,6 +225,8 @@ private:
     static const u16 DEFAULT_PORT = 80;
     //! Default connection timeout, in milliseconds
     static const u32 DEFAULT_TIMEOUT = 10000;
+    //! Delay between connection attempts, in milliseconds
+    static const u32 CONNECT_WAIT = 10;
     //! Size of temporary buffer when receiving a response
     static const int TEMP_BUFFER_SIZE = 512;
 
@@ -0,0 +1,68 @@
+#include <libkiwi.h>
+
+namespace kiwi {
+
+/**
+ * @brief LCG multiplier
+ */
+const u64 PcgRandom::MULTIPLIER = 6364136223846793005ULL;
+
+/**
+ * @brief Set random seed
+ *
+ * @param seed New seed
+ * @param stream Stream index
+ */
+void PcgRandom::SetSeed(u32 seed, u32 stream) {
+    mSeed = seed;
+    mStream = stream;
+
+    mState = 0;
+    mInc = (static_cast<u64>(stream) << 1) | 1;
+
+    NextU32();
+    mState += seed;
+    NextU32();
+}
+
+/**
+ * @brief Advance the generator
+ *
+ * @param delta Number of outputs to skip
+ */
+void PcgRandom::Advance(u64 delta) {
+    u64 accMult = 1;
+    u64 accPlus = 0;
+
+    u64 curMult = MULTIPLIER;
+    u64 curPlus = mInc;
+
+    // Square-and-multiply on the LCG step (F. Brown, 1994)
+    for (; delta > 0; delta >>= 1) {
+        if (delta & 1) {
+            accMult *= curMult;
+            accPlus = accPlus * curMult + curPlus;
+        }
+
+        curPlus = (curMult + 1) * curPlus;
+        curMult *= curMult;
+    }
+
+    mState = accMult * mState + accPlus;
+}
+
+/**
+ * @brief Get random u32 (unbounded)
+ */
+u32 PcgRandom::NextU32() {
+    u64 old = mState;
+    mState = old * MULTIPLIER + mInc;
+
+    // Output permutation (xorshift high, random rotate)
+    u32 xorshifted = static_cast<u32>(((old >> 18) ^ old) >> 27);
+    u32 rot = static_cast<u32>(old >> 59);
+
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+} // namespace kiwi
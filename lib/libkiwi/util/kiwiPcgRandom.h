@@ -0,0 +1,170 @@
+#ifndef LIBKIWI_UTIL_PCG_RANDOM_H
+#define LIBKIWI_UTIL_PCG_RANDOM_H
+#include <libkiwi/debug/kiwiAssert.h>
+#include <libkiwi/k_types.h>
+#include <revolution/OS.h>
+
+namespace kiwi {
+//! @addtogroup libkiwi_util
+//! @{
+
+/**
+ * @brief Random number generator (PCG32, XSH-RR variant)
+ * @details Every stream is a different full-period (2^64) sequence, and any
+ * position in a stream can be reached in O(log n) steps. Use a different
+ * stream or a far-apart position for each instance to keep them disjoint.
+ */
+class PcgRandom {
+public:
+    /**
+     * @brief Constructor
+     */
+    PcgRandom() {
+        SetSeed(OSGetTick());
+    }
+    /**
+     * @brief Constructor
+     *
+     * @param seed Initial seed
+     * @param stream Stream index
+     */
+    PcgRandom(u32 seed, u32 stream) {
+        SetSeed(seed, stream);
+    }
+
+    /**
+     * @brief Set random seed
+     *
+     * @param seed New seed
+     * @param stream Stream index
+     */
+    void SetSeed(u32 seed, u32 stream = 0);
+
+    /**
+     * @brief Get random seed (as given to SetSeed)
+     */
+    u32 GetSeed() const {
+        return mSeed;
+    }
+    /**
+     * @brief Get stream index (as given to SetSeed)
+     */
+    u32 GetStream() const {
+        return mStream;
+    }
+
+    /**
+     * @brief Advance the generator
+     *
+     * @param delta Number of outputs to skip
+     */
+    void Advance(u64 delta);
+
+    /**
+     * @brief Get random u32 (unbounded)
+     */
+    u32 NextU32();
+
+    /**
+     * @brief Get random s32 (unbounded)
+     */
+    s32 NextS32() {
+        return static_cast<s32>(NextU32());
+    }
+
+    /**
+     * @brief Get random u32 (upper bound)
+     *
+     * @param max Upper bound (exclusive)
+     */
+    u32 NextU32(u32 max) {
+        // Multiply-shift keeps every output bit in play
+        return static_cast<u32>((static_cast<u64>(NextU32()) * max) >> 32);
+    }
+
+    /**
+     * @brief Get random s32 (upper bound)
+     *
+     * @param max Upper bound (exclusive)
+     */
+    s32 NextS32(s32 max) {
+        return static_cast<s32>(NextU32(max));
+    }
+
+    /**
+     * @brief Get random u32 (lower+upper bound)
+     *
+     * @param min Lower bound (inclusive)
+     * @param max Upper bound (exclusive)
+     */
+    u32 NextU32(u32 min, u32 max) {
+        K_ASSERT(min < max);
+        return min + NextU32(max - min);
+    }
+
+    /**
+     * @brief Get random s32 (lower+upper bound)
+     *
+     * @param min Lower bound (inclusive)
+     * @param max Upper bound (exclusive)
+     */
+    s32 NextS32(s32 min, s32 max) {
+        return static_cast<s32>(NextU32(min, max));
+    }
+
+    /**
+     * @brief Get random float -> [0.0 - 1.0)
+     */
+    f32 NextF32() {
+        // Top 24 bits fit the float mantissa exactly
+        return (NextU32() >> 8) / static_cast<f32>(1 << 24);
+    }
+
+    /**
+     * @brief Get random float (upper bound)
+     *
+     * @param max Upper bound (exclusive)
+     */
+    f32 NextF32(f32 max) {
+        return NextF32() * max;
+    }
+
+    /**
+     * @brief Roll random chance
+     *
+     * @param p Probability to succeed
+     */
+    bool Chance(f32 p) {
+        K_ASSERT(p <= 1.0f);
+        return NextF32() < p;
+    }
+
+    /**
+     * @brief Roll coin-flip (50% chance)
+     */
+    bool CoinFlip() {
+        return Chance(0.5f);
+    }
+
+    /**
+     * @brief Roll random sign
+     */
+    f32 Sign() {
+        return Chance(0.5f) ? 1.0f : -1.0f;
+    }
+
+private:
+    //! LCG multiplier
+    static const u64 MULTIPLIER;
+
+private:
+    u64 mState;  // Generator state
+    u64 mInc;    // Stream increment (always odd)
+    u32 mSeed;   // Initial seed
+    u32 mStream; // Stream index
+};
+
+//! @}
+} // namespace kiwi
+
+#endif
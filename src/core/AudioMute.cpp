@@ -0,0 +1,53 @@
+#include "core/AudioMute.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ */
+AudioMute::AudioMute()
+    : mStartSoundIdPatch(0x801b38f8, CodePatch::INSN_LI_R3_0,
+                         CodePatch::INSN_BLR),
+      mStartSoundNamePatch(0x801b384c, CodePatch::INSN_LI_R3_0,
+                           CodePatch::INSN_BLR),
+      mIsMute(false),
+      mIsStopped(false) {}
+
+/**
+ * @brief Mutes or unmutes the game's sound starts
+ *
+ * @param mute Whether sound starts should be stubbed
+ */
+void AudioMute::SetMute(bool mute) {
+    // Sounds have nowhere to play once the audio system is stopped
+    if (mIsStopped) {
+        mute = true;
+    }
+
+    // Hits and collisions still request sound effects
+    mStartSoundIdPatch.Set(mute);
+    mStartSoundNamePatch.Set(mute);
+
+    mIsMute = mute;
+}
+
+/**
+ * @brief Stops the audio system (once)
+ * @note Sound starts are muted first, as nothing can play them anymore
+ */
+void AudioMute::Stop() {
+    if (mIsStopped) {
+        return;
+    }
+
+    // Stub sound starts before stopping the mixer
+    SetMute(true);
+    __OSStopAudioSystem();
+
+    mIsStopped = true;
+}
+
+} // namespace BAH
@@ -0,0 +1,64 @@
+#ifndef BAH_CLIENT_CORE_AUDIO_MUTE_H
+#define BAH_CLIENT_CORE_AUDIO_MUTE_H
+#include "core/CodePatch.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Silences the game for instances without audio
+ * @details Sound starts are stubbed, and the audio system can be stopped
+ * entirely. Once stopped, it stays stopped until the next boot.
+ */
+class AudioMute : public kiwi::StaticSingleton<AudioMute> {
+    friend class kiwi::StaticSingleton<AudioMute>;
+
+public:
+    /**
+     * @brief Mutes or unmutes the game's sound starts
+     *
+     * @param mute Whether sound starts should be stubbed
+     */
+    void SetMute(bool mute);
+    /**
+     * @brief Tests whether the game's sound starts are stubbed
+     */
+    bool IsMute() const {
+        return mIsMute;
+    }
+
+    /**
+     * @brief Stops the audio system (once)
+     * @note Sound starts are muted first, as nothing can play them anymore
+     */
+    void Stop();
+    /**
+     * @brief Tests whether the audio system has been stopped
+     */
+    bool IsStopped() const {
+        return mIsStopped;
+    }
+
+private:
+    /**
+     * @brief Constructor
+     */
+    AudioMute();
+
+private:
+    //! RPSndAudioMgr::startSound(SoundHandle*, u32) -> return false
+    CodePatch mStartSoundIdPatch;
+    //! RPSndAudioMgr::startSound(SoundHandle*, const char*) -> return false
+    CodePatch mStartSoundNamePatch;
+
+    //! Whether sound starts are stubbed
+    bool mIsMute;
+    //! Whether the audio system has been stopped
+    bool mIsStopped;
+};
+
+} // namespace BAH
+
+#endif
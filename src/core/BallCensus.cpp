@@ -0,0 +1,221 @@
+#include "core/BallCensus.h"
+
+#include "core/NandUtil.h"
+#include <Pack/RPParty.h>
+
+#include <libkiwi.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+//! NAND file name
+const char* FILE_NAME = "census.bin";
+
+} // namespace
+
+const f32 BallCensus::NEAR_RATIO = 0.25f;
+
+/**
+ * @brief Constructor
+ */
+BallCensus::BallCensus()
+    : mSunkNum(0),
+      mOffNum(0),
+      mIsFoul(false),
+      mNearMiss(-1.0f),
+      mHasArea(false),
+      mCalibrateNum(0),
+      mIsFixed(false),
+      mMinX(0.0f),
+      mMaxX(0.0f),
+      mMinZ(0.0f),
+      mMaxZ(0.0f) {
+
+    std::memset(mFlags, 0, sizeof(mFlags));
+    std::memset(mPosX, 0, sizeof(mPosX));
+    std::memset(mPosZ, 0, sizeof(mPosZ));
+
+    Load();
+}
+
+/**
+ * @brief Gathers the current state of every ball
+ */
+void BallCensus::Take() {
+    mSunkNum = 0;
+    mOffNum = 0;
+    mIsFoul = false;
+
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
+        ASSERT(pBall != nullptr);
+
+        u8 flags = 0;
+        flags |= pBall->IsState(RPBilBall::EState_Pocket) ? FLAG_POCKET : 0;
+        flags |= pBall->IsState(RPBilBall::EState_OffTable) ? FLAG_OFF : 0;
+
+        mFlags[i] = flags;
+        mPosX[i] = pBall->GetPosition().x;
+        mPosZ[i] = pBall->GetPosition().z;
+
+        // Any ball shot off the table is a foul
+        mIsFoul |= (flags & FLAG_OFF) != 0;
+
+        // Cue ball pocketed?
+        if (pBall->IsCueBall()) {
+            ASSERT(i == 0);
+            mIsFoul |= (flags & FLAG_POCKET) != 0;
+            continue;
+        }
+
+        mSunkNum += (flags & FLAG_POCKET) != 0 ? 1 : 0;
+        mOffNum += (flags & FLAG_OFF) != 0 ? 1 : 0;
+    }
+
+    Calibrate();
+    mNearMiss = CalcNearMiss();
+}
+
+/**
+ * @brief Grows the play area to include the resting balls
+ */
+void BallCensus::Calibrate() {
+    // Scores must not depend on earlier breaks
+    if (mIsFixed) {
+        return;
+    }
+
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        if (mFlags[i] != 0) {
+            continue;
+        }
+
+        if (!mHasArea) {
+            mMinX = mMaxX = mPosX[i];
+            mMinZ = mMaxZ = mPosZ[i];
+            mHasArea = true;
+            continue;
+        }
+
+        mMinX = kiwi::Min(mMinX, mPosX[i]);
+        mMaxX = kiwi::Max(mMaxX, mPosX[i]);
+        mMinZ = kiwi::Min(mMinZ, mPosZ[i]);
+        mMaxZ = kiwi::Max(mMaxZ, mPosZ[i]);
+    }
+
+    if (++mCalibrateNum < CALIBRATE_NUM) {
+        return;
+    }
+
+    // Play area is still degenerate
+    if (mMaxX - mMinX <= 0.0f || mMaxZ - mMinZ <= 0.0f) {
+        return;
+    }
+
+    mIsFixed = true;
+    Save();
+
+    K_LOG_EX("Play area fixed: X [%.3f, %.3f], Z [%.3f, %.3f]\n", mMinX,
+             mMaxX, mMinZ, mMaxZ);
+}
+
+/**
+ * @brief Calculates the near-miss score of the resting balls
+ */
+f32 BallCensus::CalcNearMiss() const {
+    // Pockets are not placed yet
+    if (!mIsFixed) {
+        return -1.0f;
+    }
+
+    f32 width = mMaxX - mMinX;
+    f32 depth = mMaxZ - mMinZ;
+
+    f32 radius = kiwi::Min(width, depth) * NEAR_RATIO;
+    f32 midX = (mMinX + mMaxX) * 0.5f;
+    f32 midZ = (mMinZ + mMaxZ) * 0.5f;
+
+    // Corner pockets, and side pockets halfway along the long sides
+    f32 pocketX[POCKET_MAX] = {mMinX, mMaxX, mMinX, mMaxX, midX, midX};
+    f32 pocketZ[POCKET_MAX] = {mMinZ, mMinZ, mMaxZ, mMaxZ, mMinZ, mMaxZ};
+
+    if (depth > width) {
+        pocketX[4] = mMinX;
+        pocketX[5] = mMaxX;
+        pocketZ[4] = pocketZ[5] = midZ;
+    }
+
+    f32 score = 0.0f;
+
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        // Only object balls left on the table count
+        if (i == 0 || mFlags[i] != 0) {
+            continue;
+        }
+
+        f32 minDistSq = radius * radius;
+
+        for (int j = 0; j < POCKET_MAX; j++) {
+            f32 dx = mPosX[i] - pocketX[j];
+            f32 dz = mPosZ[i] - pocketZ[j];
+            minDistSq = kiwi::Min(minDistSq, dx * dx + dz * dz);
+        }
+
+        score += 1.0f - std::sqrt(minDistSq) / radius;
+    }
+
+    return score;
+}
+
+/**
+ * @brief Loads the fixed play area (from NAND)
+ */
+void BallCensus::Load() {
+    kiwi::MemStream strm =
+        kiwi::FileRipper::Open(FILE_NAME, kiwi::EStorage_NAND);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    mMinX = strm.Read_f32();
+    mMaxX = strm.Read_f32();
+    mMinZ = strm.Read_f32();
+    mMaxZ = strm.Read_f32();
+
+    // Measure again rather than score against a broken area
+    if (mMaxX - mMinX <= 0.0f || mMaxZ - mMinZ <= 0.0f) {
+        K_LOG("Discarding invalid play area\n");
+        mMinX = mMaxX = mMinZ = mMaxZ = 0.0f;
+        return;
+    }
+
+    mHasArea = true;
+    mIsFixed = true;
+}
+
+/**
+ * @brief Saves the fixed play area (to NAND)
+ */
+void BallCensus::Save() const {
+    kiwi::WorkBufferArg arg;
+    arg.size = sizeof(f32) * 4;
+    kiwi::WorkBuffer buffer(arg);
+
+    // Write play area to buffer
+    {
+        kiwi::MemStream strm(buffer);
+        strm.Write_f32(mMinX);
+        strm.Write_f32(mMaxX);
+        strm.Write_f32(mMinZ);
+        strm.Write_f32(mMaxZ);
+    }
+
+    // Save play area to the NAND
+    WriteNandFile(FILE_NAME, buffer);
+}
+
+} // namespace BAH
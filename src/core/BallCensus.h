@@ -0,0 +1,122 @@
+#ifndef BAH_CLIENT_CORE_BALL_CENSUS_H
+#define BAH_CLIENT_CORE_BALL_CENSUS_H
+#include <Pack/RPParty.h>
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Final state of every ball, gathered in a single pass
+ * @details Besides the ball counts, the census scores how close the balls
+ * left on the table came to a pocket. Pocket positions are not known ahead of
+ * time, so they are placed on the play area spanned by resting balls over the
+ * first breaks. The area is then fixed (and kept on the NAND), so the score
+ * only depends on the break; until then it is unknown.
+ */
+class BallCensus {
+public:
+    /**
+     * @brief Constructor
+     */
+    BallCensus();
+
+    /**
+     * @brief Gathers the current state of every ball
+     */
+    void Take();
+
+    /**
+     * @brief Accesses the number of balls sunk/pocketed
+     */
+    u32 GetSunkNum() const {
+        return mSunkNum;
+    }
+    /**
+     * @brief Accesses the number of balls shot off of the table
+     */
+    u32 GetOffNum() const {
+        return mOffNum;
+    }
+    /**
+     * @brief Tests whether the break shot fouled
+     */
+    bool IsFoul() const {
+        return mIsFoul;
+    }
+    /**
+     * @brief Accesses the near-miss score (0 for none, 1 per ball in a pocket)
+     * @note Negative while the play area is being measured
+     */
+    f32 GetNearMiss() const {
+        return mNearMiss;
+    }
+
+private:
+    //! Ball is pocketed (or about to be)
+    static const u8 FLAG_POCKET = 1 << 0;
+    //! Ball is off the table (or about to be)
+    static const u8 FLAG_OFF = 1 << 1;
+
+    //! Number of pockets
+    static const int POCKET_MAX = 6;
+    //! Near-miss radius, as a fraction of the short side of the play area
+    static const f32 NEAR_RATIO;
+    //! Number of censuses that measure the play area before it is fixed
+    static const u32 CALIBRATE_NUM = 256;
+
+private:
+    /**
+     * @brief Grows the play area to include the resting balls
+     */
+    void Calibrate();
+    /**
+     * @brief Loads the fixed play area (from NAND)
+     */
+    void Load();
+    /**
+     * @brief Saves the fixed play area (to NAND)
+     */
+    void Save() const;
+    /**
+     * @brief Calculates the near-miss score of the resting balls
+     */
+    f32 CalcNearMiss() const;
+
+private:
+    //! Ball state flags
+    u8 mFlags[RPBilBallManager::BALL_MAX];
+    //! Ball X positions
+    f32 mPosX[RPBilBallManager::BALL_MAX];
+    //! Ball Z positions
+    f32 mPosZ[RPBilBallManager::BALL_MAX];
+
+    //! Number of balls sunk/pocketed
+    u32 mSunkNum;
+    //! Number of balls shot off of the table
+    u32 mOffNum;
+    //! Whether the break shot fouled
+    bool mIsFoul;
+    //! Near-miss score
+    f32 mNearMiss;
+
+    //! Whether any resting ball has been seen
+    bool mHasArea;
+    //! Censuses that measured the play area
+    u32 mCalibrateNum;
+    //! Whether the play area is fixed
+    bool mIsFixed;
+    //! Play area minimum X
+    f32 mMinX;
+    //! Play area maximum X
+    f32 mMaxX;
+    //! Play area minimum Z
+    f32 mMinZ;
+    //! Play area maximum Z
+    f32 mMaxZ;
+};
+
+} // namespace BAH
+
+#endif
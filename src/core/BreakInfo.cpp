@@ -1,5 +1,6 @@
 #include "core/BreakInfo.h"
 
+#include "core/NandUtil.h"
 #include "core/Simulation.h"
 
 #include <libkiwi.h>
@@ -21,7 +22,12 @@ BreakInfo::BreakInfo()
       pos(),
       power(0.0f),
       foul(false),
-      checksum(0) {}
+      checksum(0),
+      source(ESource_None),
+      style(0),
+      stream(0),
+      index(0),
+      nearMiss(-1.0f) {}
 
 /**
  * @brief Deserializes break from stream
@@ -42,6 +48,15 @@ void BreakInfo::Read(kiwi::MemStream& rStrm) {
     power = rStrm.Read_f32();
     foul = rStrm.Read_s32();
     checksum = rStrm.Read_u32();
+    nearMiss = -1.0f;
+
+    // Older files end (or are zero-padded) before the source
+    source = rStrm.IsEOF() ? ESource_None : rStrm.Read_u8();
+    if (source != ESource_None) {
+        style = rStrm.Read_u8();
+        stream = rStrm.Read_u32();
+        index = rStrm.Read_u64();
+    }
 
     u32 expected = CalcChecksum();
     K_WARN_EX(checksum != expected,
@@ -68,6 +83,10 @@ void BreakInfo::Write(kiwi::MemStream& rStrm) const {
     rStrm.Write_f32(power);
     rStrm.Write_s32(foul);
     rStrm.Write_u32(CalcChecksum());
+    rStrm.Write_u8(source);
+    rStrm.Write_u8(style);
+    rStrm.Write_u32(stream);
+    rStrm.Write_u64(index);
 }
 
 /**
@@ -87,6 +106,10 @@ void BreakInfo::Log() const {
     LOG_EX("    pos:\t{%08X, %08X}\n", kiwi::BitCast<u32>(pos.x), kiwi::BitCast<u32>(pos.y));
     LOG_EX("    power:\t%08X\n",       kiwi::BitCast<u32>(power));
     LOG_EX("    foul:\t%s\n",          foul ? "true" : "false");
+    LOG_EX("    source:\t%d\n",        source);
+    LOG_EX("    style:\t%d\n",         style);
+    LOG_EX("    stream:\t%08X\n",      stream);
+    LOG_EX("    index:\t%016llX\n",    index);
     LOG("}\n");
     // clang-format on
 }
@@ -99,6 +122,13 @@ u32 BreakInfo::CalcChecksum() const {
 
     // Don't include 'checksum' member
     crc.Process(this, offsetof(BreakInfo, checksum));
+
+    // Newer records also protect what makes them reproducible
+    if (GetFormat() >= FORMAT_SOURCE) {
+        crc.Process(&source, offsetof(BreakInfo, nearMiss) -
+                                 offsetof(BreakInfo, source));
+    }
+
     return crc.Result();
 }
 
@@ -153,25 +183,7 @@ void BreakInfo::Save(const kiwi::String& rName) const {
     }
 
     // Save break info to the NAND
-    {
-        kiwi::NandStream strm(kiwi::EOpenMode_Write);
-
-        for (int i = 0; i < NAND_RETRY_NUM; i++) {
-            // Attempt to open file
-            if (strm.Open(rName)) {
-                break;
-            }
-
-            // Failed? Try again in one second
-            volatile s64 x = OSGetTime();
-            while (OSGetTime() - x < OS_SEC_TO_TICKS(1)) {
-                ;
-            }
-        }
-
-        ASSERT_EX(strm.IsOpen(), "NAND error");
-        strm.Write(buffer, buffer.AlignedSize());
-    }
+    WriteNandFile(rName, buffer);
 }
 
 /**
@@ -190,6 +202,7 @@ bool BreakInfo::Upload(kiwi::EHttpErr& rError, s32& rExError,
 
         // clang-format off
         request.SetParameter("user",     *Simulation::GetInstance().GetUniqueID());
+        request.SetParameter("format",   GetFormat());
         request.SetParameter("seed",     kiwi::ToHexString(seed));
         request.SetParameter("kseed",    kiwi::ToHexString(kseed));
         request.SetParameter("sunk",     sunk);
@@ -203,6 +216,10 @@ bool BreakInfo::Upload(kiwi::EHttpErr& rError, s32& rExError,
         request.SetParameter("power",    kiwi::ToHexString(power));
         request.SetParameter("foul",     kiwi::ToHexString(foul));
         request.SetParameter("checksum", kiwi::ToHexString(CalcChecksum()));
+        request.SetParameter("source",   static_cast<u32>(source));
+        request.SetParameter("style",    static_cast<u32>(style));
+        request.SetParameter("stream",   kiwi::ToHexString(stream));
+        request.SetParameter("index",    index);
         // clang-format on
 
         const kiwi::HttpResponse& rResp = request.Send();
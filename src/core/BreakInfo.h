@@ -10,6 +10,17 @@ namespace BAH {
  */
 #pragma pack(push, 1)
 struct BreakInfo {
+    /**
+     * @brief Origin of the aiming and hit
+     */
+    enum ESource {
+        ESource_None,      //!< Unknown (older records)
+        ESource_Random,    //!< libkiwi LCG (kseed is its state)
+        ESource_Pcg,       //!< libkiwi PCG32 (kseed, stream, and index)
+        ESource_Enumerate, //!< Parameter space (style and index)
+        ESource_Local      //!< Local search (kseed is its LCG state)
+    };
+
     u32 seed;  //!< RPUtlRandom seed
     u32 kseed; //!< libkiwi seed
 
@@ -25,7 +36,19 @@ struct BreakInfo {
     f32 power;         //!< Cue power
 
     bool foul;    //!< Foul status
-    u32 checksum; //!< Data checksum
+    u32 checksum; //!< Data checksum (see GetFormat)
+
+    u8 source;  //!< Origin of the aiming and hit (ESource)
+    u8 style;   //!< Randomization style
+    u32 stream; //!< PCG32 stream
+    u64 index;  //!< PCG32 position or parameter space index
+
+    f32 nearMiss; //!< Near-miss score (negative if unknown, not saved)
+
+    //! Record format without the source fields
+    static const u32 FORMAT_LEGACY = 1;
+    //! Record format with the source fields (covered by the checksum)
+    static const u32 FORMAT_SOURCE = 2;
 
     //! Maximum attempts at NAND operations
     static const int NAND_RETRY_NUM = 10;
@@ -54,6 +77,13 @@ struct BreakInfo {
      */
     void Log() const;
 
+    /**
+     * @brief Gets the record format (determines the checksum coverage)
+     */
+    u32 GetFormat() const {
+        return source != ESource_None ? FORMAT_SOURCE : FORMAT_LEGACY;
+    }
+
     /**
      * @brief Calculates data checksum
      */
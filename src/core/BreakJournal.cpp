@@ -0,0 +1,213 @@
+#include "core/BreakJournal.h"
+
+#include "core/NandUtil.h"
+
+#include <libkiwi.h>
+
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+//! NAND file name (records grew with the break source, so older journals
+//! are left alone)
+const char* FILE_NAME = "journal2.bin";
+
+} // namespace
+
+/**
+ * @brief Constructor
+ *
+ * @param batchNum Number of pending records that triggers a write
+ */
+BreakJournal::BreakJournal(u32 batchNum)
+    : mBatchNum(batchNum),
+      mpBlock(nullptr),
+      mBlockIndex(0),
+      mSlot(0),
+      mNextSequence(1),
+      mPendingNum(0),
+      mBest(),
+      mHasBest(false) {
+
+    ASSERT(mBatchNum > 0);
+
+    mpBlock = new (32, kiwi::EMemory_MEM2) u8[BLOCK_SIZE];
+    ASSERT(mpBlock != nullptr);
+    std::memset(mpBlock, 0, BLOCK_SIZE);
+
+    Recover();
+}
+
+/**
+ * @brief Destructor
+ */
+BreakJournal::~BreakJournal() {
+    Flush();
+
+    delete[] mpBlock;
+    mpBlock = nullptr;
+}
+
+/**
+ * @brief Adds a break to the journal
+ *
+ * @param rBreak Break
+ */
+void BreakJournal::Append(const BreakInfo& rBreak) {
+    WriteRecord(mSlot++, mNextSequence++, rBreak);
+    mPendingNum++;
+
+    UpdateBest(rBreak);
+
+    // Full blocks are never written again
+    if (mSlot == RECORD_PER_BLOCK) {
+        Flush();
+
+        std::memset(mpBlock, 0, BLOCK_SIZE);
+        mBlockIndex++;
+        mSlot = 0;
+        return;
+    }
+
+    if (mPendingNum >= mBatchNum) {
+        Flush();
+    }
+}
+
+/**
+ * @brief Writes pending records (to NAND)
+ */
+void BreakJournal::Flush() {
+    if (mPendingNum == 0) {
+        return;
+    }
+
+    // Whole block is rewritten, so the file grows in block steps
+    WriteNandFile(FILE_NAME, mpBlock, BLOCK_SIZE, mBlockIndex * BLOCK_SIZE);
+    mPendingNum = 0;
+}
+
+/**
+ * @brief Scans the journal for the last valid record (from NAND)
+ */
+void BreakJournal::Recover() {
+    kiwi::NandStream strm(FILE_NAME, kiwi::EOpenMode_Read);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    u32 fileSize = strm.GetSize();
+
+    for (u32 offset = 0; offset < fileSize; offset += BLOCK_SIZE) {
+        // Torn writes may leave a partial block
+        u32 readSize = fileSize - offset;
+        if (readSize > BLOCK_SIZE) {
+            readSize = BLOCK_SIZE;
+        }
+
+        std::memset(mpBlock, 0, BLOCK_SIZE);
+        strm.Read(mpBlock, ROUND_DOWN(readSize, 32));
+
+        mBlockIndex = offset / BLOCK_SIZE;
+
+        for (mSlot = 0; mSlot < RECORD_PER_BLOCK; mSlot++) {
+            BreakInfo info;
+            if (!ReadRecord(mSlot, mNextSequence, info)) {
+                break;
+            }
+
+            UpdateBest(info);
+            mNextSequence++;
+        }
+
+        // Last valid record was found
+        if (mSlot < RECORD_PER_BLOCK) {
+            break;
+        }
+    }
+
+    // Journal ended on a block boundary
+    if (mSlot == RECORD_PER_BLOCK) {
+        std::memset(mpBlock, 0, BLOCK_SIZE);
+        mBlockIndex++;
+        mSlot = 0;
+    }
+
+    // Discard the torn tail, it is overwritten by the next write
+    std::memset(mpBlock + mSlot * RECORD_SIZE, 0,
+                BLOCK_SIZE - mSlot * RECORD_SIZE);
+
+    K_LOG_EX("Journal: %u breaks\n", GetRecordNum());
+}
+
+/**
+ * @brief Reads a record from the block buffer
+ *
+ * @param slot Record slot
+ * @param sequence Expected sequence number
+ * @param[out] rBreak Break
+ * @return Whether the record is valid
+ */
+bool BreakJournal::ReadRecord(u32 slot, u32 sequence, BreakInfo& rBreak) const {
+    u8* pRecord = mpBlock + slot * RECORD_SIZE;
+
+    kiwi::MemStream strm(pRecord, RECORD_SIZE);
+
+    if (strm.Read_u32() != sequence) {
+        return false;
+    }
+
+    // Checksum covers everything before it
+    kiwi::Checksum crc;
+    crc.Process(pRecord, RECORD_SIZE - sizeof(u32));
+
+    strm.Seek(kiwi::ESeekDir_Begin, RECORD_SIZE - sizeof(u32));
+    if (strm.Read_u32() != crc.Result()) {
+        return false;
+    }
+
+    strm.Seek(kiwi::ESeekDir_Begin, sizeof(u32));
+    rBreak.Read(strm);
+
+    return true;
+}
+
+/**
+ * @brief Writes a record to the block buffer
+ *
+ * @param slot Record slot
+ * @param sequence Sequence number
+ * @param rBreak Break
+ */
+void BreakJournal::WriteRecord(u32 slot, u32 sequence,
+                               const BreakInfo& rBreak) {
+    u8* pRecord = mpBlock + slot * RECORD_SIZE;
+    std::memset(pRecord, 0, RECORD_SIZE);
+
+    kiwi::MemStream strm(pRecord, RECORD_SIZE);
+    strm.Write_u32(sequence);
+    rBreak.Write(strm);
+
+    // Checksum covers everything before it
+    kiwi::Checksum crc;
+    crc.Process(pRecord, RECORD_SIZE - sizeof(u32));
+
+    strm.Seek(kiwi::ESeekDir_Begin, RECORD_SIZE - sizeof(u32));
+    strm.Write_u32(crc.Result());
+}
+
+/**
+ * @brief Tracks the best break in the journal
+ *
+ * @param rBreak Break
+ */
+void BreakJournal::UpdateBest(const BreakInfo& rBreak) {
+    if (!mHasBest || rBreak.IsBetterThan(mBest)) {
+        mBest = rBreak;
+        mHasBest = true;
+    }
+}
+
+} // namespace BAH
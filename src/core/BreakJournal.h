@@ -0,0 +1,131 @@
+#ifndef BAH_CLIENT_CORE_BREAK_JOURNAL_H
+#define BAH_CLIENT_CORE_BREAK_JOURNAL_H
+#include "core/BreakInfo.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Append-only history of breaks (on NAND)
+ * @details The journal is a sequence of fixed-size records, each with a
+ * sequence number and checksum. Records are gathered in a buffer the size of
+ * one NAND block, which is written in place once enough records are pending.
+ * On startup, the journal is scanned up to the first record that is invalid or
+ * out of sequence, and anything past it (a torn write) is overwritten.
+ */
+class BreakJournal {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param batchNum Number of pending records that triggers a write
+     */
+    explicit BreakJournal(u32 batchNum);
+    /**
+     * @brief Destructor
+     */
+    ~BreakJournal();
+
+    /**
+     * @brief Adds a break to the journal
+     *
+     * @param rBreak Break
+     */
+    void Append(const BreakInfo& rBreak);
+    /**
+     * @brief Writes pending records (to NAND)
+     */
+    void Flush();
+
+    /**
+     * @brief Accesses the number of records in the journal
+     */
+    u32 GetRecordNum() const {
+        return mNextSequence - 1;
+    }
+    /**
+     * @brief Accesses the number of records not yet written
+     */
+    u32 GetPendingNum() const {
+        return mPendingNum;
+    }
+
+    /**
+     * @brief Tests whether the journal holds any break
+     */
+    bool HasBest() const {
+        return mHasBest;
+    }
+    /**
+     * @brief Accesses the best break in the journal
+     */
+    const BreakInfo& GetBest() const {
+        return mBest;
+    }
+
+private:
+    //! Size of one record, in bytes
+    static const u32 RECORD_SIZE = 128;
+    //! Size of one NAND block, in bytes
+    static const u32 BLOCK_SIZE = 16 * 1024;
+    //! Number of records in one block
+    static const u32 RECORD_PER_BLOCK = BLOCK_SIZE / RECORD_SIZE;
+
+private:
+    /**
+     * @brief Scans the journal for the last valid record (from NAND)
+     */
+    void Recover();
+
+    /**
+     * @brief Reads a record from the block buffer
+     *
+     * @param slot Record slot
+     * @param sequence Expected sequence number
+     * @param[out] rBreak Break
+     * @return Whether the record is valid
+     */
+    bool ReadRecord(u32 slot, u32 sequence, BreakInfo& rBreak) const;
+    /**
+     * @brief Writes a record to the block buffer
+     *
+     * @param slot Record slot
+     * @param sequence Sequence number
+     * @param rBreak Break
+     */
+    void WriteRecord(u32 slot, u32 sequence, const BreakInfo& rBreak);
+
+    /**
+     * @brief Tracks the best break in the journal
+     *
+     * @param rBreak Break
+     */
+    void UpdateBest(const BreakInfo& rBreak);
+
+private:
+    //! Number of pending records that triggers a write
+    u32 mBatchNum;
+
+    //! Contents of the block being appended to
+    u8* mpBlock;
+    //! Index of the block being appended to
+    u32 mBlockIndex;
+    //! Next free record slot in the block
+    u32 mSlot;
+
+    //! Sequence number of the next record
+    u32 mNextSequence;
+    //! Number of records not yet written
+    u32 mPendingNum;
+
+    //! Best break in the journal
+    BreakInfo mBest;
+    //! Whether the journal holds any break
+    bool mHasBest;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,87 @@
+#include "core/CodePatch.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+#include <cstring>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param addr Instruction address
+ * @param insn Replacement instruction
+ */
+CodePatch::CodePatch(u32 addr, u32 insn)
+    : mpAddr(reinterpret_cast<u32*>(addr)), mInsnNum(1), mIsApplied(false) {
+
+    ASSERT(mpAddr != nullptr);
+
+    mInsns[0] = insn;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param addr Instruction address
+ * @param insn0 First replacement instruction
+ * @param insn1 Second replacement instruction
+ */
+CodePatch::CodePatch(u32 addr, u32 insn0, u32 insn1)
+    : mpAddr(reinterpret_cast<u32*>(addr)), mInsnNum(2), mIsApplied(false) {
+
+    ASSERT(mpAddr != nullptr);
+
+    mInsns[0] = insn0;
+    mInsns[1] = insn1;
+}
+
+/**
+ * @brief Destructor
+ */
+CodePatch::~CodePatch() {
+    Revert();
+}
+
+/**
+ * @brief Writes the replacement instructions
+ */
+void CodePatch::Apply() {
+    if (mIsApplied) {
+        return;
+    }
+
+    std::memcpy(mOrigInsns, mpAddr, mInsnNum * sizeof(u32));
+    Write(mInsns);
+    mIsApplied = true;
+}
+
+/**
+ * @brief Restores the original instructions
+ */
+void CodePatch::Revert() {
+    if (!mIsApplied) {
+        return;
+    }
+
+    Write(mOrigInsns);
+    mIsApplied = false;
+}
+
+/**
+ * @brief Writes instructions and synchronizes the caches
+ *
+ * @param pInsns Instructions
+ */
+void CodePatch::Write(const u32* pInsns) {
+    ASSERT(pInsns != nullptr);
+
+    std::memcpy(mpAddr, pInsns, mInsnNum * sizeof(u32));
+
+    // Push the new instructions out of the data cache
+    DCFlushRange(mpAddr, mInsnNum * sizeof(u32));
+    ICInvalidateRange(mpAddr, mInsnNum * sizeof(u32));
+}
+
+} // namespace BAH
@@ -0,0 +1,93 @@
+#ifndef BAH_CLIENT_CORE_CODE_PATCH_H
+#define BAH_CLIENT_CORE_CODE_PATCH_H
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Reversible instruction patch (up to two instructions)
+ * @details Unlike Kamek patches, these can be applied and reverted at runtime.
+ */
+class CodePatch {
+public:
+    //! Branch to link register
+    static const u32 INSN_BLR = 0x4E800020;
+    //! Load zero into r3 (return false)
+    static const u32 INSN_LI_R3_0 = 0x38600000;
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param addr Instruction address
+     * @param insn Replacement instruction
+     */
+    CodePatch(u32 addr, u32 insn);
+    /**
+     * @brief Constructor
+     *
+     * @param addr Instruction address
+     * @param insn0 First replacement instruction
+     * @param insn1 Second replacement instruction
+     */
+    CodePatch(u32 addr, u32 insn0, u32 insn1);
+    /**
+     * @brief Destructor
+     */
+    ~CodePatch();
+
+    /**
+     * @brief Writes the replacement instructions
+     */
+    void Apply();
+    /**
+     * @brief Restores the original instructions
+     */
+    void Revert();
+
+    /**
+     * @brief Applies or reverts the patch
+     *
+     * @param enable Whether the patch should be applied
+     */
+    void Set(bool enable) {
+        enable ? Apply() : Revert();
+    }
+
+    /**
+     * @brief Tests whether the patch is currently applied
+     */
+    bool IsApplied() const {
+        return mIsApplied;
+    }
+
+private:
+    //! Maximum number of patched instructions
+    static const int INSN_MAX = 2;
+
+private:
+    /**
+     * @brief Writes instructions and synchronizes the caches
+     *
+     * @param pInsns Instructions
+     */
+    void Write(const u32* pInsns);
+
+private:
+    //! Instruction address
+    u32* mpAddr;
+    //! Number of patched instructions
+    int mInsnNum;
+
+    //! Replacement instructions
+    u32 mInsns[INSN_MAX];
+    //! Original instructions
+    u32 mOrigInsns[INSN_MAX];
+
+    //! Whether the patch is currently applied
+    bool mIsApplied;
+};
+
+} // namespace BAH
+
+#endif
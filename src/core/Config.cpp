@@ -0,0 +1,293 @@
+#include "core/Config.h"
+
+#include <libkiwi.h>
+
+namespace BAH {
+namespace {
+
+/**
+ * @brief Reads a boolean option
+ *
+ * @param rRoot Root object
+ * @param pName Option name
+ * @param[out] rValue Option value
+ */
+void ReadOption(const kiwi::json::Object& rRoot, const char* pName,
+                bool& rValue) {
+    const kiwi::json::Element* pElem = rRoot.Find(pName);
+
+    if (pElem == nullptr) {
+        return;
+    }
+
+    if (pElem->GetType() != kiwi::json::Element::EType_Boolean) {
+        K_LOG_EX("Option %s should be a boolean\n", pName);
+        return;
+    }
+
+    rValue = pElem->Get<bool>();
+}
+
+/**
+ * @brief Reads a numeric option
+ *
+ * @param rRoot Root object
+ * @param pName Option name
+ * @param[out] rValue Option value
+ */
+void ReadOption(const kiwi::json::Object& rRoot, const char* pName,
+                f64& rValue) {
+    const kiwi::json::Element* pElem = rRoot.Find(pName);
+
+    if (pElem == nullptr) {
+        return;
+    }
+
+    if (pElem->GetType() != kiwi::json::Element::EType_Number) {
+        K_LOG_EX("Option %s should be a number\n", pName);
+        return;
+    }
+
+    rValue = pElem->Get<f64>();
+}
+
+/**
+ * @brief Reads an unsigned integer option
+ *
+ * @param rRoot Root object
+ * @param pName Option name
+ * @param[out] rValue Option value
+ */
+void ReadOption(const kiwi::json::Object& rRoot, const char* pName,
+                u32& rValue) {
+    f64 value = rValue;
+    ReadOption(rRoot, pName, value);
+    rValue = static_cast<u32>(value);
+}
+
+/**
+ * @brief Reads a floating-point option
+ *
+ * @param rRoot Root object
+ * @param pName Option name
+ * @param[out] rValue Option value
+ */
+void ReadOption(const kiwi::json::Object& rRoot, const char* pName,
+                f32& rValue) {
+    f64 value = rValue;
+    ReadOption(rRoot, pName, value);
+    rValue = static_cast<f32>(value);
+}
+
+/**
+ * @brief Reads a string option
+ *
+ * @param rRoot Root object
+ * @param pName Option name
+ * @param[out] rValue Option value
+ */
+void ReadOption(const kiwi::json::Object& rRoot, const char* pName,
+                kiwi::String& rValue) {
+    const kiwi::json::Element* pElem = rRoot.Find(pName);
+
+    if (pElem == nullptr) {
+        return;
+    }
+
+    if (pElem->GetType() != kiwi::json::Element::EType_String) {
+        K_LOG_EX("Option %s should be a string\n", pName);
+        return;
+    }
+
+    rValue = pElem->Get<kiwi::String>();
+}
+
+} // namespace
+
+/**
+ * @brief Constructor
+ */
+Config::Config()
+    : mFastAim(false),
+      mTableSnapshot(false),
+      mTableSnapshotVerify(false),
+      mForkNum(1),
+      mForkPowerMin(150.0f),
+      mPrune(false),
+      mPruneEpsilon(0.001f),
+      mPruneChain(0),
+      mPruneValidate(false),
+      mSettle(false),
+      mSettleEpsilon(0.001f),
+      mSettleValidate(false),
+      mFrameMax(60 * 60),
+      mBatchMsec(0),
+      mHeadless(false),
+      mHeadlessDrawSec(5),
+      mAudio(true),
+      mUnthrottle(false),
+      mReplayPolicy(EReplayPolicy_Normal),
+      mReplayTicks(8),
+      mEnumerate(false),
+      mShard(0),
+      mShardNum(1),
+      mLease(false),
+      mLocalSearch(0.0f),
+      mLocalSearchMin(7),
+      mLocalSearchSeed(false),
+      mBandit(false),
+      mBanditFloor(0.1f),
+      mExplored(false),
+      mExploredKB(512),
+      mPcgRandom(false),
+      mRandomBench(false),
+      mSeedSchedule(false),
+      mSeedBase(0),
+      mSeedStride(1),
+      mLeaderboard(false),
+      mLeaderboardNum(16),
+      mJournal(false),
+      mJournalBatch(8),
+      mResume(false),
+      mResumeSec(60),
+      mNandAsync(false),
+      mUploadQueue(false),
+      mUploadQueueNum(16) {
+
+    Load();
+}
+
+/**
+ * @brief Loads options from the DVD
+ */
+void Config::Load() {
+    u32 size = 0;
+
+    kiwi::FileRipperArg arg;
+    arg.pSize = &size;
+
+    // Configuration file is optional
+    void* pFile = kiwi::FileRipper::Rip("config.json", kiwi::EStorage_DVD, arg);
+    if (pFile == nullptr) {
+        return;
+    }
+
+    kiwi::json::Reader reader;
+    reader.Decode(pFile, size);
+    delete[] static_cast<u8*>(pFile);
+
+    const kiwi::json::Element& rRoot = reader.Get();
+    if (rRoot.GetType() != kiwi::json::Element::EType_Object) {
+        K_LOG("Ignoring malformed config.json\n");
+        return;
+    }
+
+    Read(rRoot.Get<kiwi::json::Object>());
+}
+
+/**
+ * @brief Reads options from the root JSON object
+ *
+ * @param rRoot Root object
+ */
+void Config::Read(const kiwi::json::Object& rRoot) {
+    ReadOption(rRoot, "fastAim", mFastAim);
+    ReadOption(rRoot, "tableSnapshot", mTableSnapshot);
+    ReadOption(rRoot, "tableSnapshotVerify", mTableSnapshotVerify);
+    ReadOption(rRoot, "forkNum", mForkNum);
+    ReadOption(rRoot, "forkPowerMin", mForkPowerMin);
+    ReadOption(rRoot, "prune", mPrune);
+    ReadOption(rRoot, "pruneEpsilon", mPruneEpsilon);
+    ReadOption(rRoot, "pruneChain", mPruneChain);
+    ReadOption(rRoot, "pruneValidate", mPruneValidate);
+    ReadOption(rRoot, "settle", mSettle);
+    ReadOption(rRoot, "settleEpsilon", mSettleEpsilon);
+    ReadOption(rRoot, "settleValidate", mSettleValidate);
+    ReadOption(rRoot, "frameMax", mFrameMax);
+    ReadOption(rRoot, "batchMsec", mBatchMsec);
+    ReadOption(rRoot, "headless", mHeadless);
+    ReadOption(rRoot, "headlessDrawSec", mHeadlessDrawSec);
+    ReadOption(rRoot, "audio", mAudio);
+    ReadOption(rRoot, "unthrottle", mUnthrottle);
+
+    kiwi::String replay;
+    ReadOption(rRoot, "replay", replay);
+
+    if (replay == "skip") {
+        mReplayPolicy = EReplayPolicy_Skip;
+    } else if (replay == "fast") {
+        mReplayPolicy = EReplayPolicy_Fast;
+    } else if (replay == "defer") {
+        mReplayPolicy = EReplayPolicy_Defer;
+    } else if (!replay.Empty() && replay != "normal") {
+        K_LOG_EX("Unknown replay policy %s\n", replay.CStr());
+    }
+
+    ReadOption(rRoot, "replayTicks", mReplayTicks);
+
+    ReadOption(rRoot, "enumerate", mEnumerate);
+    ReadOption(rRoot, "shard", mShard);
+    ReadOption(rRoot, "shardNum", mShardNum);
+
+    if (mShardNum == 0 || mShard >= mShardNum) {
+        K_LOG_EX("Invalid shard %u/%u\n", mShard, mShardNum);
+        mShard = 0;
+        mShardNum = 1;
+    }
+
+    ReadOption(rRoot, "lease", mLease);
+
+    ReadOption(rRoot, "localSearch", mLocalSearch);
+    ReadOption(rRoot, "localSearchMin", mLocalSearchMin);
+    ReadOption(rRoot, "localSearchSeed", mLocalSearchSeed);
+
+    ReadOption(rRoot, "bandit", mBandit);
+    ReadOption(rRoot, "banditFloor", mBanditFloor);
+
+    ReadOption(rRoot, "explored", mExplored);
+    ReadOption(rRoot, "exploredKB", mExploredKB);
+
+    ReadOption(rRoot, "pcgRandom", mPcgRandom);
+    ReadOption(rRoot, "randomBench", mRandomBench);
+
+    ReadOption(rRoot, "seedSchedule", mSeedSchedule);
+    ReadOption(rRoot, "seedBase", mSeedBase);
+    ReadOption(rRoot, "seedStride", mSeedStride);
+
+    // Every break would share the same seed
+    if (mSeedStride == 0) {
+        K_LOG("Invalid seed stride 0\n");
+        mSeedStride = 1;
+    }
+
+    ReadOption(rRoot, "leaderboard", mLeaderboard);
+    ReadOption(rRoot, "leaderboardNum", mLeaderboardNum);
+
+    if (mLeaderboardNum == 0) {
+        K_LOG("Invalid leaderboard size 0\n");
+        mLeaderboardNum = 16;
+    }
+
+    ReadOption(rRoot, "journal", mJournal);
+    ReadOption(rRoot, "journalBatch", mJournalBatch);
+
+    if (mJournalBatch == 0) {
+        K_LOG("Invalid journal batch 0\n");
+        mJournalBatch = 8;
+    }
+
+    ReadOption(rRoot, "resume", mResume);
+    ReadOption(rRoot, "resumeSec", mResumeSec);
+
+    ReadOption(rRoot, "nandAsync", mNandAsync);
+
+    ReadOption(rRoot, "uploadQueue", mUploadQueue);
+    ReadOption(rRoot, "uploadQueueNum", mUploadQueueNum);
+
+    if (mUploadQueueNum == 0) {
+        K_LOG("Invalid upload queue size 0\n");
+        mUploadQueueNum = 16;
+    }
+}
+
+} // namespace BAH
@@ -0,0 +1,459 @@
+#ifndef BAH_CLIENT_CORE_CONFIG_H
+#define BAH_CLIENT_CORE_CONFIG_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Simulation options (from DVD)
+ * @details Options are read from "config.json" when it is placed by the user.
+ * Any missing option keeps its default value.
+ */
+class Config : public kiwi::StaticSingleton<Config> {
+    friend class kiwi::StaticSingleton<Config>;
+
+public:
+    /**
+     * @brief What happens to breaks that beat the session best
+     */
+    enum EReplayPolicy {
+        EReplayPolicy_Normal, //!< Replay at normal speed
+        EReplayPolicy_Skip,   //!< Do not replay
+        EReplayPolicy_Fast,   //!< Replay with several ticks per frame
+        EReplayPolicy_Defer   //!< Queue the replay to be watched later
+    };
+
+public:
+    /**
+     * @brief Tests whether aiming should be applied in a single tick
+     */
+    bool IsFastAim() const {
+        return mFastAim;
+    }
+
+    /**
+     * @brief Tests whether the table should be reset from a snapshot
+     */
+    bool IsTableSnapshot() const {
+        return mTableSnapshot;
+    }
+    /**
+     * @brief Tests whether snapshot restores should keep being checked
+     * against breaks from real resets
+     */
+    bool IsTableSnapshotVerify() const {
+        return mTableSnapshotVerify;
+    }
+
+    /**
+     * @brief Accesses the number of variants simulated per aiming
+     */
+    u32 GetForkNum() const {
+        return mForkNum;
+    }
+    /**
+     * @brief Accesses the minimum cue power of variants
+     */
+    f32 GetForkPowerMin() const {
+        return mForkPowerMin;
+    }
+
+    /**
+     * @brief Tests whether hopeless breaks should end early
+     */
+    bool IsPrune() const {
+        return mPrune;
+    }
+    /**
+     * @brief Accesses the speed below which a ball is considered stopped
+     */
+    f32 GetPruneEpsilon() const {
+        return mPruneEpsilon;
+    }
+    /**
+     * @brief Accesses the resting balls each moving ball may knock in (zero
+     * for no limit)
+     */
+    u32 GetPruneChain() const {
+        return mPruneChain;
+    }
+    /**
+     * @brief Tests whether pruned breaks should be finished and checked
+     * against their bound
+     */
+    bool IsPruneValidate() const {
+        return mPruneValidate;
+    }
+
+    /**
+     * @brief Tests whether shots should end once all balls are at rest
+     */
+    bool IsSettle() const {
+        return mSettle;
+    }
+    /**
+     * @brief Accesses the speed below which a ball is considered at rest
+     */
+    f32 GetSettleEpsilon() const {
+        return mSettleEpsilon;
+    }
+    /**
+     * @brief Tests whether settled results should be checked against the
+     * full shot
+     */
+    bool IsSettleValidate() const {
+        return mSettleValidate;
+    }
+
+    /**
+     * @brief Accesses the frame limit of a single break (zero for none)
+     */
+    u32 GetFrameMax() const {
+        return mFrameMax;
+    }
+
+    /**
+     * @brief Accesses the time spent simulating breaks per scene frame
+     */
+    u32 GetBatchMsec() const {
+        return mBatchMsec;
+    }
+
+    /**
+     * @brief Tests whether scene rendering should be suppressed
+     */
+    bool IsHeadless() const {
+        return mHeadless;
+    }
+    /**
+     * @brief Accesses the interval between drawn frames in headless mode
+     */
+    u32 GetHeadlessDrawSec() const {
+        return mHeadlessDrawSec;
+    }
+
+    /**
+     * @brief Tests whether the audio system should keep running
+     */
+    bool IsAudio() const {
+        return mAudio;
+    }
+
+    /**
+     * @brief Tests whether the main loop should skip the display's retrace
+     * wait
+     */
+    bool IsUnthrottle() const {
+        return mUnthrottle;
+    }
+
+    /**
+     * @brief Accesses the replay policy for new best breaks
+     */
+    EReplayPolicy GetReplayPolicy() const {
+        return mReplayPolicy;
+    }
+    /**
+     * @brief Accesses the number of ticks per frame of fast replays
+     */
+    u32 GetReplayTicks() const {
+        return mReplayTicks;
+    }
+
+    /**
+     * @brief Tests whether break parameters should be enumerated
+     */
+    bool IsEnumerate() const {
+        return mEnumerate;
+    }
+    /**
+     * @brief Accesses this client's shard offset
+     */
+    u32 GetShard() const {
+        return mShard;
+    }
+    /**
+     * @brief Accesses the total number of shards
+     */
+    u32 GetShardNum() const {
+        return mShardNum;
+    }
+    /**
+     * @brief Tests whether enumerated blocks should be leased from the server
+     */
+    bool IsLease() const {
+        return mLease;
+    }
+
+    /**
+     * @brief Accesses the fraction of breaks spent searching around the best
+     */
+    f32 GetLocalSearch() const {
+        return mLocalSearch;
+    }
+    /**
+     * @brief Accesses the minimum ball count of breaks searched around
+     */
+    u32 GetLocalSearchMin() const {
+        return mLocalSearchMin;
+    }
+    /**
+     * @brief Tests whether local search should keep the table layout (seed)
+     */
+    bool IsLocalSearchSeed() const {
+        return mLocalSearchSeed;
+    }
+
+    /**
+     * @brief Tests whether styles should be allocated by their yield
+     */
+    bool IsBandit() const {
+        return mBandit;
+    }
+    /**
+     * @brief Accesses the fraction of styles picked uniformly by the bandit
+     */
+    f32 GetBanditFloor() const {
+        return mBanditFloor;
+    }
+
+    /**
+     * @brief Tests whether explored configurations should be redrawn
+     */
+    bool IsExplored() const {
+        return mExplored;
+    }
+    /**
+     * @brief Accesses the size of the explored index (in kilobytes)
+     */
+    u32 GetExploredKB() const {
+        return mExploredKB;
+    }
+
+    /**
+     * @brief Tests whether random breaks should use the PCG32 generator
+     */
+    bool IsPcgRandom() const {
+        return mPcgRandom;
+    }
+    /**
+     * @brief Tests whether the random generators should be benchmarked
+     */
+    bool IsRandomBench() const {
+        return mRandomBench;
+    }
+
+    /**
+     * @brief Tests whether break seeds should follow the seed schedule
+     */
+    bool IsSeedSchedule() const {
+        return mSeedSchedule;
+    }
+    /**
+     * @brief Accesses the RPUtlRandom seed the schedule starts from
+     */
+    u32 GetSeedBase() const {
+        return mSeedBase;
+    }
+    /**
+     * @brief Accesses the number of RPUtlRandom steps between scheduled seeds
+     */
+    u32 GetSeedStride() const {
+        return mSeedStride;
+    }
+
+    /**
+     * @brief Tests whether the best breaks should be kept in a leaderboard
+     */
+    bool IsLeaderboard() const {
+        return mLeaderboard;
+    }
+    /**
+     * @brief Accesses the number of top breaks kept by the leaderboard
+     */
+    u32 GetLeaderboardNum() const {
+        return mLeaderboardNum;
+    }
+
+    /**
+     * @brief Tests whether qualifying breaks should be kept in a journal
+     */
+    bool IsJournal() const {
+        return mJournal;
+    }
+    /**
+     * @brief Accesses the number of journal records written together
+     */
+    u32 GetJournalBatch() const {
+        return mJournalBatch;
+    }
+
+    /**
+     * @brief Tests whether search progress should be resumed after restarts
+     */
+    bool IsResume() const {
+        return mResume;
+    }
+    /**
+     * @brief Accesses the interval between resume checkpoints (in seconds)
+     */
+    u32 GetResumeSec() const {
+        return mResumeSec;
+    }
+
+    /**
+     * @brief Tests whether NAND files should be written in the background
+     */
+    bool IsNandAsync() const {
+        return mNandAsync;
+    }
+
+    /**
+     * @brief Tests whether breaks should be uploaded on a worker thread
+     */
+    bool IsUploadQueue() const {
+        return mUploadQueue;
+    }
+    /**
+     * @brief Accesses the maximum number of breaks waiting for upload
+     */
+    u32 GetUploadQueueNum() const {
+        return mUploadQueueNum;
+    }
+
+private:
+    /**
+     * @brief Constructor
+     */
+    Config();
+
+    /**
+     * @brief Loads options from the DVD
+     */
+    void Load();
+    /**
+     * @brief Reads options from the root JSON object
+     *
+     * @param rRoot Root object
+     */
+    void Read(const kiwi::json::Object& rRoot);
+
+private:
+    //! Apply all aiming steps in one tick (skipped frames may not replay
+    //! identically, so this stays off until replays are shown to match)
+    bool mFastAim;
+
+    //! Reset the table from a snapshot
+    bool mTableSnapshot;
+    //! Keep checking snapshot restores against breaks from real resets
+    bool mTableSnapshotVerify;
+
+    //! Variants simulated per aiming
+    u32 mForkNum;
+    //! Minimum cue power of variants
+    f32 mForkPowerMin;
+
+    //! End hopeless breaks early
+    bool mPrune;
+    //! Speed below which a ball is considered stopped
+    f32 mPruneEpsilon;
+    //! Resting balls each moving ball may knock in (zero for no limit)
+    u32 mPruneChain;
+    //! Finish pruned breaks and check them against their bound
+    bool mPruneValidate;
+
+    //! End shots once all balls are at rest
+    bool mSettle;
+    //! Speed below which a ball is considered at rest
+    f32 mSettleEpsilon;
+    //! Check settled results against the full shot
+    bool mSettleValidate;
+
+    //! Frame limit of a single break
+    u32 mFrameMax;
+
+    //! Time spent simulating breaks per scene frame (in milliseconds)
+    u32 mBatchMsec;
+
+    //! Suppress scene rendering
+    bool mHeadless;
+    //! Interval between drawn frames in headless mode (in seconds)
+    u32 mHeadlessDrawSec;
+
+    //! Keep the audio system running
+    bool mAudio;
+
+    //! Skip the display's retrace wait during search
+    bool mUnthrottle;
+
+    //! Replay policy for new best breaks
+    EReplayPolicy mReplayPolicy;
+    //! Ticks per frame of fast replays
+    u32 mReplayTicks;
+
+    //! Walk the parameter space with a low-discrepancy sequence
+    bool mEnumerate;
+    //! This client's shard offset
+    u32 mShard;
+    //! Total number of shards
+    u32 mShardNum;
+    //! Lease enumerated blocks from the server
+    bool mLease;
+
+    //! Fraction of breaks spent searching around the best break
+    f32 mLocalSearch;
+    //! Minimum ball count (sunk + off) of breaks searched around
+    u32 mLocalSearchMin;
+    //! Keep the RPUtlRandom seed of breaks searched around
+    bool mLocalSearchSeed;
+
+    //! Allocate breaks between styles by their yield
+    bool mBandit;
+    //! Fraction of styles picked uniformly by the bandit
+    f32 mBanditFloor;
+
+    //! Redraw configurations that were already simulated
+    bool mExplored;
+    //! Size of the explored index (in kilobytes)
+    u32 mExploredKB;
+
+    //! Draw random breaks from the PCG32 generator
+    bool mPcgRandom;
+    //! Benchmark the random generators on startup
+    bool mRandomBench;
+
+    //! Place breaks at scheduled points of the RPUtlRandom sequence
+    bool mSeedSchedule;
+    //! RPUtlRandom seed the schedule starts from
+    u32 mSeedBase;
+    //! RPUtlRandom steps between scheduled seeds
+    u32 mSeedStride;
+
+    //! Keep the best breaks in a leaderboard
+    bool mLeaderboard;
+    //! Number of top breaks kept by the leaderboard
+    u32 mLeaderboardNum;
+
+    //! Keep qualifying breaks in an append-only journal
+    bool mJournal;
+    //! Number of journal records written together
+    u32 mJournalBatch;
+
+    //! Resume search progress after restarts
+    bool mResume;
+    //! Interval between resume checkpoints (in seconds)
+    u32 mResumeSec;
+
+    //! Write NAND files in the background
+    bool mNandAsync;
+
+    //! Upload breaks on a worker thread
+    bool mUploadQueue;
+    //! Maximum number of breaks waiting for upload
+    u32 mUploadQueueNum;
+};
+
+} // namespace BAH
+
+#endif
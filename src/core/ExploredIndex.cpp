@@ -0,0 +1,211 @@
+#include "core/ExploredIndex.h"
+
+#include "core/NandUtil.h"
+#include "core/NandWriter.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+//! NAND file name
+const char* FILE_NAME = "explored.bin";
+
+} // namespace
+
+/**
+ * @brief Key units per unit of cue position
+ * @note Positions span hundredths, so this keeps thousands of steps
+ */
+const f32 ExploredIndex::POS_SCALE = 100000.0f;
+/**
+ * @brief Key units per unit of cue power
+ */
+const f32 ExploredIndex::POWER_SCALE = 100.0f;
+
+/**
+ * @brief Constructor
+ *
+ * @param size Filter size, in bytes
+ */
+ExploredIndex::ExploredIndex(u32 size)
+    : mpData(nullptr),
+      mpHeader(nullptr),
+      mpBlocks(nullptr),
+      mBlockNum(size / BLOCK_SIZE),
+      mIsDirty(false),
+      mSaveTime(OSGetTime()),
+      mTestNum(0),
+      mHitNum(0) {
+
+    ASSERT(mBlockNum > 0);
+
+    u32 dataSize = HEADER_SIZE + mBlockNum * BLOCK_SIZE;
+
+    mpData = new (32, kiwi::EMemory_MEM2) u8[dataSize];
+    ASSERT(mpData != nullptr);
+
+    mpHeader = reinterpret_cast<Header*>(mpData);
+    mpBlocks = mpData + HEADER_SIZE;
+
+    std::memset(mpData, 0, dataSize);
+    mpHeader->size = mBlockNum * BLOCK_SIZE;
+    mpHeader->version = KEY_VERSION;
+
+    Load();
+}
+
+/**
+ * @brief Destructor
+ */
+ExploredIndex::~ExploredIndex() {
+    Flush();
+
+    delete[] mpData;
+    mpData = nullptr;
+}
+
+/**
+ * @brief Adds a break configuration to the set
+ *
+ * @param rBreak Break configuration
+ * @return Whether the configuration was (probably) already in the set
+ */
+bool ExploredIndex::TestAndInsert(const BreakInfo& rBreak) {
+    Key key;
+    std::memset(&key, 0, sizeof(Key));
+
+    key.seed = rBreak.seed;
+    key.up = rBreak.up;
+    key.left = rBreak.left;
+    key.right = rBreak.right;
+    key.x = Quantize(rBreak.pos.x, POS_SCALE);
+    key.y = Quantize(rBreak.pos.y, POS_SCALE);
+    key.power = Quantize(rBreak.power, POWER_SCALE);
+
+    // First hash picks the block, second hash the bits inside it
+    key.salt = 0;
+    u8* pBlock = mpBlocks + (kiwi::Hash(key) % mBlockNum) * BLOCK_SIZE;
+    key.salt = 1;
+    u32 bits = kiwi::Hash(key);
+
+    bool found = true;
+
+    for (u32 i = 0; i < BIT_NUM; i++) {
+        // One byte of the hash per bit (256 bits per block)
+        u32 bit = (bits >> (i * 8)) & 0xFF;
+
+        u8& rByte = pBlock[bit / 8];
+        u8 mask = 1 << (bit % 8);
+
+        if ((rByte & mask) == 0) {
+            rByte |= mask;
+            mpHeader->setBitNum++;
+            found = false;
+        }
+    }
+
+    mTestNum++;
+
+    if (found) {
+        mHitNum++;
+        return true;
+    }
+
+    mpHeader->insertNum++;
+    mIsDirty = true;
+
+    // Checkpoint so the set survives restarts
+    s64 interval = OS_SEC_TO_TICKS(static_cast<s64>(SAVE_SEC));
+    if (OSGetTime() - mSaveTime >= interval) {
+        Flush();
+    }
+
+    return false;
+}
+
+/**
+ * @brief Saves the filter if it changed since the last save (to NAND)
+ */
+void ExploredIndex::Flush() {
+    if (!mIsDirty) {
+        return;
+    }
+
+    Save();
+
+    mIsDirty = false;
+    mSaveTime = OSGetTime();
+}
+
+/**
+ * @brief Estimates the false positive rate from the filter occupancy
+ */
+f32 ExploredIndex::CalcFalsePositiveRate() const {
+    f64 fill = static_cast<f64>(mpHeader->setBitNum) /
+               (static_cast<f64>(mBlockNum) * BLOCK_SIZE * 8);
+
+    return static_cast<f32>(std::pow(fill, static_cast<f64>(BIT_NUM)));
+}
+
+/**
+ * @brief Saves the filter (to NAND)
+ */
+void ExploredIndex::Save() const {
+    u32 size = HEADER_SIZE + mBlockNum * BLOCK_SIZE;
+
+    // Filter is too large to write in the break loop, so always queue it
+    if (NandWriter::GetInstance().Write(FILE_NAME, mpData, size, 0)) {
+        return;
+    }
+
+    WriteNandFile(FILE_NAME, mpData, size);
+}
+
+/**
+ * @brief Loads the filter (from NAND)
+ */
+void ExploredIndex::Load() {
+    u32 size = HEADER_SIZE + mBlockNum * BLOCK_SIZE;
+    kiwi::NandStream strm(FILE_NAME, kiwi::EOpenMode_Read);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    // Filter was saved with a different size
+    if (strm.GetSize() != size) {
+        K_LOG("Discarding old explored index\n");
+        return;
+    }
+
+    strm.Read(mpData, size);
+
+    // Keys of older filters do not match the current ones
+    if (mpHeader->version != KEY_VERSION) {
+        K_LOG("Discarding old explored index\n");
+
+        std::memset(mpData, 0, size);
+        mpHeader->size = mBlockNum * BLOCK_SIZE;
+        mpHeader->version = KEY_VERSION;
+        return;
+    }
+
+    K_LOG_EX("Explored index: %u configurations\n", mpHeader->insertNum);
+}
+
+/**
+ * @brief Rounds a value to the nearest key unit
+ *
+ * @param value Value
+ * @param scale Key units per unit of the value
+ */
+s32 ExploredIndex::Quantize(f32 value, f32 scale) {
+    return static_cast<s32>(std::floor(value * scale + 0.5f));
+}
+
+} // namespace BAH
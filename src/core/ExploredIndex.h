@@ -0,0 +1,143 @@
+#ifndef BAH_CLIENT_CORE_EXPLORED_INDEX_H
+#define BAH_CLIENT_CORE_EXPLORED_INDEX_H
+#include "core/BreakInfo.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Probabilistic set of break configurations that were simulated
+ * @details Blocked Bloom filter keyed on the aiming, hit, and seed of a break.
+ * The hit is quantized, so configurations closer than the key resolution are
+ * the same configuration. Each key only touches one 32-byte block (one cache
+ * line). False positives are possible, false negatives are not. The filter
+ * is checkpointed to NAND in the background.
+ */
+class ExploredIndex {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param size Filter size, in bytes
+     */
+    explicit ExploredIndex(u32 size);
+    /**
+     * @brief Destructor
+     */
+    ~ExploredIndex();
+
+    /**
+     * @brief Adds a break configuration to the set
+     *
+     * @param rBreak Break configuration
+     * @return Whether the configuration was (probably) already in the set
+     */
+    bool TestAndInsert(const BreakInfo& rBreak);
+
+    /**
+     * @brief Accesses the number of configurations tested
+     */
+    u32 GetTestNum() const {
+        return mTestNum;
+    }
+    /**
+     * @brief Accesses the number of configurations found in the set
+     */
+    u32 GetHitNum() const {
+        return mHitNum;
+    }
+
+    /**
+     * @brief Estimates the false positive rate from the filter occupancy
+     */
+    f32 CalcFalsePositiveRate() const;
+
+    /**
+     * @brief Saves the filter if it changed since the last save (to NAND)
+     */
+    void Flush();
+
+private:
+    /**
+     * @brief Filter file header
+     */
+    struct Header {
+        u32 size;      //!< Filter size, in bytes
+        u32 insertNum; //!< Number of inserted configurations
+        u32 setBitNum; //!< Number of set bits
+        u32 version;   //!< Key layout version
+    };
+
+    /**
+     * @brief Filter key
+     */
+    struct Key {
+        u32 salt;  //!< Hash salt
+        u32 seed;  //!< RPUtlRandom seed
+        s32 up;    //!< Frames aimed up
+        s32 left;  //!< Frames aimed left
+        s32 right; //!< Frames aimed right
+        s32 x;     //!< Cue X position (quantized)
+        s32 y;     //!< Cue Y position (quantized)
+        s32 power; //!< Cue power (quantized)
+    };
+
+    //! Size of one block, in bytes
+    static const u32 BLOCK_SIZE = 32;
+    //! Size of the header area, in bytes (keeps the blocks aligned)
+    static const u32 HEADER_SIZE = 32;
+    //! Bits set per key
+    static const u32 BIT_NUM = 4;
+    //! Minimum time between NAND checkpoints (in seconds)
+    static const u32 SAVE_SEC = 300;
+    //! Layout version of the keys
+    static const u32 KEY_VERSION = 1;
+
+    //! Key units per unit of cue position
+    static const f32 POS_SCALE;
+    //! Key units per unit of cue power
+    static const f32 POWER_SCALE;
+
+private:
+    /**
+     * @brief Loads the filter (from NAND)
+     */
+    void Load();
+    /**
+     * @brief Saves the filter (to NAND)
+     */
+    void Save() const;
+
+    /**
+     * @brief Rounds a value to the nearest key unit
+     *
+     * @param value Value
+     * @param scale Key units per unit of the value
+     */
+    static s32 Quantize(f32 value, f32 scale);
+
+private:
+    //! Header followed by the filter blocks
+    u8* mpData;
+    //! Filter header
+    Header* mpHeader;
+    //! Filter blocks
+    u8* mpBlocks;
+    //! Number of filter blocks
+    u32 mBlockNum;
+
+    //! Whether the filter changed since the last checkpoint
+    bool mIsDirty;
+    //! Time of the last checkpoint
+    s64 mSaveTime;
+    //! Number of configurations tested this session
+    u32 mTestNum;
+    //! Number of configurations found in the set this session
+    u32 mHitNum;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,104 @@
+#include "core/Headless.h"
+
+#include "core/Config.h"
+#include "core/Simulation.h"
+
+#include <Pack/RPSystem.h>
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+// RPSysScene::draw, resolved per pack from base/symbols_*.txt
+extern "C" void draw__10RPSysSceneFv();
+
+namespace BAH {
+
+namespace {
+
+//! RPSysScene::draw address
+const u32 DRAW_ADDR = reinterpret_cast<u32>(&draw__10RPSysSceneFv);
+
+} // namespace
+
+/**
+ * @brief Constructor
+ */
+Headless::Headless()
+    : mDrawPatch(DRAW_ADDR, CodePatch::INSN_BLR),
+      mDrawTime(OSGetTime()),
+      mIsChecked(false),
+      mIsSupported(false) {}
+
+/**
+ * @brief Decides whether the upcoming scene frame is drawn
+ */
+void Headless::Calculate() {
+    // Replays are meant to be watched
+    if (!Config::GetInstance().IsHeadless() ||
+        Simulation::GetInstance().IsReplay()) {
+        mDrawPatch.Revert();
+        return;
+    }
+
+    // Only check once per scene, as the patch hides the original code
+    if (!mIsChecked) {
+        mIsSupported = CheckSupport();
+        mIsChecked = true;
+    }
+
+    if (!mIsSupported) {
+        return;
+    }
+
+    u32 interval = Config::GetInstance().GetHeadlessDrawSec();
+    s64 now = OSGetTime();
+
+    bool draw = interval > 0 &&
+                now - mDrawTime >= OS_SEC_TO_TICKS(static_cast<s64>(interval));
+
+    if (draw) {
+        mDrawTime = now;
+        Simulation::GetInstance().LogStatus();
+    }
+
+    mDrawPatch.Set(!draw);
+}
+
+/**
+ * @brief Restores scene rendering (on scene exit)
+ */
+void Headless::Exit() {
+    // Other scenes share RPSysScene::draw
+    mDrawPatch.Revert();
+
+    // The next scene may draw differently
+    mIsChecked = false;
+}
+
+/**
+ * @brief Tests whether the draw patch is safe for the current scene
+ */
+bool Headless::CheckSupport() const {
+    const EGG::Scene* pScene =
+        RP_GET_INSTANCE(RPSysSceneMgr)->getCurrentScene();
+    ASSERT(pScene != nullptr);
+
+    // Patching the base function does nothing if the scene overrides it
+    const u32* pVtable = *reinterpret_cast<const u32* const*>(pScene);
+    if (pVtable[DRAW_VT_SLOT] != DRAW_ADDR) {
+        K_LOG("Headless disabled: scene overrides RPSysScene::draw\n");
+        return false;
+    }
+
+    // Make sure the symbol points at the start of the real function
+    u32 insn = *reinterpret_cast<const u32*>(DRAW_ADDR);
+    if ((insn & PROLOGUE_MASK) != INSN_STWU_R1) {
+        K_LOG_EX("Headless disabled: unexpected code %08X at %08X\n", insn,
+                 DRAW_ADDR);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace BAH
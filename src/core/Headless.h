@@ -0,0 +1,62 @@
+#ifndef BAH_CLIENT_CORE_HEADLESS_H
+#define BAH_CLIENT_CORE_HEADLESS_H
+#include "core/CodePatch.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Suppresses scene rendering while the search runs
+ * @details A frame is still drawn periodically (along with a console status
+ * line) so the instance can be checked on.
+ */
+class Headless : public kiwi::StaticSingleton<Headless> {
+    friend class kiwi::StaticSingleton<Headless>;
+
+public:
+    /**
+     * @brief Decides whether the upcoming scene frame is drawn
+     */
+    void Calculate();
+    /**
+     * @brief Restores scene rendering (on scene exit)
+     */
+    void Exit();
+
+private:
+    /**
+     * @brief Constructor
+     */
+    Headless();
+
+    /**
+     * @brief Tests whether the draw patch is safe for the current scene
+     */
+    bool CheckSupport() const;
+
+private:
+    //! Vtable slot of RPSysScene::draw
+    static const int DRAW_VT_SLOT = 0x10 / sizeof(u32);
+
+    //! Mask for the stack frame prologue (stwu r1, -N(r1))
+    static const u32 PROLOGUE_MASK = 0xFFFF0000;
+    //! Expected first instruction of RPSysScene::draw (offset masked)
+    static const u32 INSN_STWU_R1 = 0x94210000;
+
+private:
+    //! Disables RPSysScene::draw
+    CodePatch mDrawPatch;
+    //! Time of the last drawn frame
+    s64 mDrawTime;
+
+    //! Whether the current scene has been checked
+    bool mIsChecked;
+    //! Whether the draw patch is safe for the current scene
+    bool mIsSupported;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef BAH_CLIENT_CORE_I_BREAK_PRUNER_H
+#define BAH_CLIENT_CORE_I_BREAK_PRUNER_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Break pruning predicate interface
+ * @details Pruners estimate the best possible result of a break in progress,
+ * so hopeless breaks can end before the game's end-of-shot.
+ */
+class IBreakPruner {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~IBreakPruner() {}
+
+    /**
+     * @brief Prepares the pruner for a new break
+     */
+    virtual void Reset() = 0;
+
+    /**
+     * @brief Calculates an upper bound on the final ball count (sunk + off)
+     *
+     * @return Ball count bound, or none if it cannot be known yet
+     */
+    virtual kiwi::Optional<u32> CalcBound() = 0;
+};
+
+} // namespace BAH
+
+#endif
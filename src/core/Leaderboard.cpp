@@ -0,0 +1,315 @@
+#include "core/Leaderboard.h"
+
+#include "core/NandUtil.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+//! NAND file name
+const char* FILE_NAME = "leaderboard.bin";
+
+//! File magic
+const u32 MAGIC = 'LDBD';
+
+} // namespace
+
+/**
+ * @brief Constructor
+ *
+ * @param capacity Number of top breaks kept
+ */
+Leaderboard::Leaderboard(u32 capacity)
+    : mpData(nullptr),
+      mpHeader(nullptr),
+      mpHeap(nullptr),
+      mpExemplars(nullptr),
+      mIsDirty(false),
+      mSaveTime(OSGetTime()) {
+
+    ASSERT(capacity > 0);
+
+    u32 dataSize = CalcDataSize(capacity);
+
+    mpData = new (32, kiwi::EMemory_MEM2) u8[dataSize];
+    ASSERT(mpData != nullptr);
+    std::memset(mpData, 0, dataSize);
+
+    mpHeader = reinterpret_cast<Header*>(mpData);
+    mpHeader->capacity = capacity;
+
+    mpHeap = reinterpret_cast<Entry*>(mpData + HEADER_SIZE);
+    mpExemplars = mpHeap + capacity;
+
+    Load();
+}
+
+/**
+ * @brief Destructor
+ */
+Leaderboard::~Leaderboard() {
+    Flush();
+
+    delete[] mpData;
+    mpData = nullptr;
+}
+
+/**
+ * @brief Calculates the ranking key of a break
+ * @details Higher keys are better, and equal keys are ties.
+ *
+ * @param rBreak Break
+ */
+u64 Leaderboard::CalcKey(const BreakInfo& rBreak) {
+    // Same priorities as BreakInfo::IsBetterThan
+    u64 key = 0;
+    key |= static_cast<u64>(rBreak.sunk + rBreak.off) << 48;
+    key |= static_cast<u64>(rBreak.sunk) << 40;
+    key |= static_cast<u64>(!rBreak.foul) << 32;
+    key |= static_cast<u64>(~rBreak.frame); // Fewer frames is better
+
+    return key;
+}
+
+/**
+ * @brief Offers a break to the leaderboard
+ * @note Saves pending changes once the save interval has passed
+ *
+ * @param rBreak Break
+ * @return Whether the leaderboard changed
+ */
+bool Leaderboard::Insert(const BreakInfo& rBreak) {
+    u64 key = CalcKey(rBreak);
+    bool changed = false;
+
+    // Best break with this ball count?
+    u32 ballNum = rBreak.sunk + rBreak.off;
+    if (ballNum < EXEMPLAR_NUM) {
+        u32 bit = 1 << ballNum;
+        Entry& rExemplar = mpExemplars[ballNum];
+
+        if (!(mpHeader->exemplarMask & bit) || key > rExemplar.key) {
+            rExemplar.key = key;
+            rExemplar.info = rBreak;
+            mpHeader->exemplarMask |= bit;
+            changed = true;
+        }
+    }
+
+    if (mpHeader->heapNum < mpHeader->capacity) {
+        // Room left in the heap
+        u32 i = mpHeader->heapNum++;
+        mpHeap[i].key = key;
+        mpHeap[i].info = rBreak;
+        SiftUp(i);
+        changed = true;
+    } else if (key > mpHeap[0].key) {
+        // Replace the weakest top break
+        mpHeap[0].key = key;
+        mpHeap[0].info = rBreak;
+        SiftDown(0);
+        changed = true;
+    }
+
+    mIsDirty |= changed;
+
+    // Saving blocks the search, so changes are written in batches
+    s64 interval = OS_SEC_TO_TICKS(static_cast<s64>(SAVE_SEC));
+    if (OSGetTime() - mSaveTime >= interval) {
+        Flush();
+    }
+
+    return changed;
+}
+
+/**
+ * @brief Saves changes made since the last save (to NAND)
+ */
+void Leaderboard::Flush() {
+    if (!mIsDirty) {
+        return;
+    }
+
+    Save();
+
+    mIsDirty = false;
+    mSaveTime = OSGetTime();
+}
+
+/**
+ * @brief Gathers the top breaks, best first
+ *
+ * @param[out] ppBreaks Break array
+ * @param max Array size
+ * @return Number of breaks written
+ */
+u32 Leaderboard::GetTop(const BreakInfo** ppBreaks, u32 max) const {
+    ASSERT(ppBreaks != nullptr);
+
+    u64 keys[TOP_MAX];
+    if (max > TOP_MAX) {
+        max = TOP_MAX;
+    }
+
+    u32 num = 0;
+    if (max == 0) {
+        return num;
+    }
+
+    // Insertion sort, the heap only has a few entries
+    for (u32 i = 0; i < mpHeader->heapNum; i++) {
+        u64 key = mpHeap[i].key;
+
+        if (num == max && key <= keys[max - 1]) {
+            continue;
+        }
+
+        u32 j = num < max ? num++ : max - 1;
+        for (; j > 0 && keys[j - 1] < key; j--) {
+            keys[j] = keys[j - 1];
+            ppBreaks[j] = ppBreaks[j - 1];
+        }
+
+        keys[j] = key;
+        ppBreaks[j] = &mpHeap[i].info;
+    }
+
+    return num;
+}
+
+/**
+ * @brief Accesses the best break with the specified ball count
+ *
+ * @param ballNum Ball count (sunk + off)
+ * @return Break, or nullptr if there is none yet
+ */
+const BreakInfo* Leaderboard::GetExemplar(u32 ballNum) const {
+    if (ballNum >= EXEMPLAR_NUM || !(mpHeader->exemplarMask & (1 << ballNum))) {
+        return nullptr;
+    }
+
+    return &mpExemplars[ballNum].info;
+}
+
+/**
+ * @brief Moves a heap entry up until its parent is not better
+ *
+ * @param i Entry index
+ */
+void Leaderboard::SiftUp(u32 i) {
+    while (i > 0) {
+        u32 parent = (i - 1) / 2;
+
+        if (mpHeap[parent].key <= mpHeap[i].key) {
+            break;
+        }
+
+        std::swap(mpHeap[parent], mpHeap[i]);
+        i = parent;
+    }
+}
+
+/**
+ * @brief Moves a heap entry down until its children are not worse
+ *
+ * @param i Entry index
+ */
+void Leaderboard::SiftDown(u32 i) {
+    u32 num = mpHeader->heapNum;
+
+    while (true) {
+        u32 min = i;
+        u32 left = i * 2 + 1;
+        u32 right = i * 2 + 2;
+
+        if (left < num && mpHeap[left].key < mpHeap[min].key) {
+            min = left;
+        }
+        if (right < num && mpHeap[right].key < mpHeap[min].key) {
+            min = right;
+        }
+
+        if (min == i) {
+            break;
+        }
+
+        std::swap(mpHeap[min], mpHeap[i]);
+        i = min;
+    }
+}
+
+/**
+ * @brief Calculates the size of the leaderboard data, in bytes
+ *
+ * @param capacity Number of top breaks kept
+ */
+u32 Leaderboard::CalcDataSize(u32 capacity) {
+    // NAND writes need a 32-byte aligned size
+    return ROUND_UP(HEADER_SIZE + (capacity + EXEMPLAR_NUM) * sizeof(Entry),
+                    32);
+}
+
+/**
+ * @brief Calculates the checksum of the leaderboard data
+ */
+u32 Leaderboard::CalcChecksum() const {
+    u32 offset = offsetof(Header, capacity);
+
+    kiwi::Checksum crc;
+    crc.Process(mpData + offset, CalcDataSize(mpHeader->capacity) - offset);
+
+    return crc.Result();
+}
+
+/**
+ * @brief Loads the leaderboard (from NAND)
+ */
+void Leaderboard::Load() {
+    u32 capacity = mpHeader->capacity;
+    u32 size = CalcDataSize(capacity);
+    kiwi::NandStream strm(FILE_NAME, kiwi::EOpenMode_Read);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    // Leaderboard was saved with a different capacity
+    if (strm.GetSize() != size) {
+        K_LOG("Discarding old leaderboard\n");
+        return;
+    }
+
+    strm.Read(mpData, size);
+
+    // Torn or foreign files must not index past the entries
+    if (mpHeader->magic != MAGIC || mpHeader->checksum != CalcChecksum() ||
+        mpHeader->capacity != capacity) {
+        K_LOG("Discarding damaged leaderboard\n");
+
+        std::memset(mpData, 0, size);
+        mpHeader->capacity = capacity;
+        return;
+    }
+
+    mpHeader->heapNum = kiwi::Min(mpHeader->heapNum, capacity);
+    mpHeader->exemplarMask &= (1 << EXEMPLAR_NUM) - 1;
+
+    K_LOG_EX("Leaderboard: %u breaks\n", mpHeader->heapNum);
+}
+
+/**
+ * @brief Saves the leaderboard (to NAND)
+ */
+void Leaderboard::Save() {
+    mpHeader->magic = MAGIC;
+    mpHeader->checksum = CalcChecksum();
+
+    WriteNandFile(FILE_NAME, mpData, CalcDataSize(mpHeader->capacity));
+}
+
+} // namespace BAH
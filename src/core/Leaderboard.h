@@ -0,0 +1,162 @@
+#ifndef BAH_CLIENT_CORE_LEADERBOARD_H
+#define BAH_CLIENT_CORE_LEADERBOARD_H
+#include "core/BreakInfo.h"
+
+#include <Pack/RPParty.h>
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Best breaks found so far
+ * @details Keeps the top breaks overall in a min-heap (so the weakest entry is
+ * replaced first), plus the best break for every ball count. Breaks are ranked
+ * by a packed key with the same ordering as BreakInfo::IsBetterThan. All
+ * entries live in one MEM2 block, which is saved to NAND in a single write at
+ * most once per interval.
+ */
+class Leaderboard {
+public:
+    //! Number of ball counts with an exemplar (0 through 9 object balls)
+    static const u32 EXEMPLAR_NUM = RPBilBallManager::BALL_MAX;
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param capacity Number of top breaks kept
+     */
+    explicit Leaderboard(u32 capacity);
+    /**
+     * @brief Destructor
+     */
+    ~Leaderboard();
+
+    /**
+     * @brief Calculates the ranking key of a break
+     * @details Higher keys are better, and equal keys are ties.
+     *
+     * @param rBreak Break
+     */
+    static u64 CalcKey(const BreakInfo& rBreak);
+
+    /**
+     * @brief Offers a break to the leaderboard
+     * @note Saves pending changes once the save interval has passed
+     *
+     * @param rBreak Break
+     * @return Whether the leaderboard changed
+     */
+    bool Insert(const BreakInfo& rBreak);
+    /**
+     * @brief Saves changes made since the last save (to NAND)
+     */
+    void Flush();
+
+    /**
+     * @brief Gathers the top breaks, best first
+     *
+     * @param[out] ppBreaks Break array
+     * @param max Array size
+     * @return Number of breaks written
+     */
+    u32 GetTop(const BreakInfo** ppBreaks, u32 max) const;
+
+    /**
+     * @brief Accesses the best break with the specified ball count
+     *
+     * @param ballNum Ball count (sunk + off)
+     * @return Break, or nullptr if there is none yet
+     */
+    const BreakInfo* GetExemplar(u32 ballNum) const;
+
+    /**
+     * @brief Accesses the number of top breaks kept
+     */
+    u32 GetNum() const {
+        return mpHeader->heapNum;
+    }
+
+private:
+    /**
+     * @brief Leaderboard file header
+     */
+    struct Header {
+        u32 magic;        //!< File magic
+        u32 checksum;     //!< Checksum of everything after it
+        u32 capacity;     //!< Number of top breaks kept
+        u32 heapNum;      //!< Number of top breaks in the heap
+        u32 exemplarMask; //!< Ball counts that have an exemplar
+    };
+
+    /**
+     * @brief Ranked break
+     */
+    struct Entry {
+        u64 key;        //!< Ranking key
+        BreakInfo info; //!< Break
+    };
+
+    //! Size of the header area, in bytes (keeps the entries aligned)
+    static const u32 HEADER_SIZE = 32;
+    //! Maximum number of breaks gathered by GetTop
+    static const u32 TOP_MAX = 32;
+    //! Minimum time between saves (in seconds)
+    static const u32 SAVE_SEC = 60;
+
+private:
+    /**
+     * @brief Moves a heap entry up until its parent is not better
+     *
+     * @param i Entry index
+     */
+    void SiftUp(u32 i);
+    /**
+     * @brief Moves a heap entry down until its children are not worse
+     *
+     * @param i Entry index
+     */
+    void SiftDown(u32 i);
+
+    /**
+     * @brief Calculates the size of the leaderboard data, in bytes
+     *
+     * @param capacity Number of top breaks kept
+     */
+    static u32 CalcDataSize(u32 capacity);
+
+    /**
+     * @brief Calculates the checksum of the leaderboard data
+     */
+    u32 CalcChecksum() const;
+
+    /**
+     * @brief Loads the leaderboard (from NAND)
+     */
+    void Load();
+    /**
+     * @brief Saves the leaderboard (to NAND)
+     */
+    void Save();
+
+private:
+    //! Header followed by the heap and exemplar entries
+    u8* mpData;
+    //! Leaderboard header
+    Header* mpHeader;
+    //! Top breaks (min-heap)
+    Entry* mpHeap;
+    //! Best break per ball count
+    Entry* mpExemplars;
+
+    //! Whether the leaderboard changed since it was saved
+    bool mIsDirty;
+    //! Time of the last save
+    s64 mSaveTime;
+};
+
+} // namespace BAH
+
+#endif
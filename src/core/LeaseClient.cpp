@@ -0,0 +1,395 @@
+#include "core/LeaseClient.h"
+
+#include "core/BreakInfo.h"
+#include "core/Simulation.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+/**
+ * @brief Reads a numeric field from a server response
+ *
+ * @param rRoot Root object
+ * @param pName Field name
+ * @param[out] rValue Field value
+ * @return Success
+ */
+bool ReadField(const kiwi::json::Object& rRoot, const char* pName,
+               f64& rValue) {
+    const kiwi::json::Element* pElem = rRoot.Find(pName);
+
+    if (pElem == nullptr ||
+        pElem->GetType() != kiwi::json::Element::EType_Number) {
+        K_LOG_EX("Lease field %s is missing\n", pName);
+        return false;
+    }
+
+    rValue = pElem->Get<f64>();
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor
+ *
+ * @param style Randomization style whose space is leased
+ */
+LeaseClient::LeaseClient(u32 style)
+    : mStyle(style),
+      mIsAcquire(false),
+      mRetryTime(0),
+      mIsExit(false),
+      mpThread(nullptr) {
+
+    mCurrLease.valid = false;
+    mNextLease.valid = false;
+    mReport.valid = false;
+
+    ClearResults();
+
+    OSInitMutex(&mMutex);
+    OSInitMessageQueue(&mMessageQueue, mMessages, MESSAGE_MAX);
+
+    // Worker starts immediately, so everything else must be ready
+    mpThread =
+        new (32, kiwi::EMemory_MEM2) kiwi::Thread(&LeaseClient::Run, *this);
+    ASSERT(mpThread != nullptr);
+}
+
+/**
+ * @brief Destructor
+ * @note Waits for the request in progress to finish
+ */
+LeaseClient::~LeaseClient() {
+    mIsExit = true;
+
+    // Wake the worker ahead of any pending requests
+    OSJamMessage(&mMessageQueue, nullptr, OS_MSG_BLOCKING);
+    mpThread->Join();
+
+    delete mpThread;
+    mpThread = nullptr;
+}
+
+/**
+ * @brief Takes the next sequence index from the current lease
+ *
+ * @return Sequence index, or none if no lease is ready yet
+ */
+kiwi::Optional<u64> LeaseClient::Next() {
+    s64 now = OSGetTime();
+
+    // Server has given expired leases to someone else
+    if (mCurrLease.valid && now >= mCurrLease.expireTime) {
+        K_LOG_EX("Lease %u expired\n", mCurrLease.id);
+        mCurrLease.valid = false;
+        ClearResults();
+    }
+
+    // Every break from the current lease has been simulated
+    if (mCurrLease.valid && mCurrLease.taken >= mCurrLease.count) {
+        QueueReport();
+        mCurrLease.valid = false;
+        ClearResults();
+    }
+
+    {
+        kiwi::AutoMutexLock lock(mMutex);
+
+        if (mNextLease.valid && now >= mNextLease.expireTime) {
+            K_LOG_EX("Lease %u expired\n", mNextLease.id);
+            mNextLease.valid = false;
+        }
+
+        if (!mCurrLease.valid && mNextLease.valid) {
+            mCurrLease = mNextLease;
+            mNextLease.valid = false;
+        }
+
+        // Lease ahead so the search never waits at the end of a lease
+        bool acquire =
+            !mCurrLease.valid || mCurrLease.count - mCurrLease.taken <=
+                                     mCurrLease.count / PREFETCH_DIV;
+
+        if (acquire && !mNextLease.valid && !mIsAcquire) {
+            mIsAcquire = true;
+            Wake();
+        }
+    }
+
+    if (!mCurrLease.valid) {
+        return kiwi::nullopt;
+    }
+
+    return mCurrLease.start + mCurrLease.taken++;
+}
+
+/**
+ * @brief Records the results of a break from the current lease
+ *
+ * @param ballNum Balls sunk or off the table
+ * @param qualify Whether the break was uploaded
+ */
+void LeaseClient::Record(u32 ballNum, bool qualify) {
+    ASSERT(ballNum < RPBilBallManager::BALL_MAX);
+
+    if (!mCurrLease.valid) {
+        return;
+    }
+
+    mBreakNum++;
+    mBreakBallNum[ballNum]++;
+    mQualifyNum += qualify ? 1 : 0;
+}
+
+/**
+ * @brief Deserializes the current lease and its results from stream
+ *
+ * @param rStrm Stream
+ */
+void LeaseClient::Read(kiwi::MemStream& rStrm) {
+    mCurrLease.valid = rStrm.Read_bool();
+    mCurrLease.id = rStrm.Read_u32();
+    mCurrLease.start = rStrm.Read_u64();
+    mCurrLease.count = rStrm.Read_u32();
+    mCurrLease.taken = rStrm.Read_u32();
+    // System time keeps running while the console is off
+    mCurrLease.expireTime = rStrm.Read_s64();
+
+    mBreakNum = rStrm.Read_u32();
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        mBreakBallNum[i] = rStrm.Read_u32();
+    }
+    mQualifyNum = rStrm.Read_u32();
+
+    if (mCurrLease.valid) {
+        K_LOG_EX("Resuming lease %u at %u of %u\n", mCurrLease.id,
+                 mCurrLease.taken, mCurrLease.count);
+    }
+}
+
+/**
+ * @brief Serializes the current lease and its results to stream
+ * @note The prefetched lease is not kept, the server reassigns it once it
+ * expires
+ *
+ * @param rStrm Stream
+ */
+void LeaseClient::Write(kiwi::MemStream& rStrm) const {
+    rStrm.Write_bool(mCurrLease.valid);
+    rStrm.Write_u32(mCurrLease.id);
+    rStrm.Write_u64(mCurrLease.start);
+    rStrm.Write_u32(mCurrLease.count);
+    rStrm.Write_u32(mCurrLease.taken);
+    rStrm.Write_s64(mCurrLease.expireTime);
+
+    rStrm.Write_u32(mBreakNum);
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        rStrm.Write_u32(mBreakBallNum[i]);
+    }
+    rStrm.Write_u32(mQualifyNum);
+}
+
+/**
+ * @brief Worker thread function
+ */
+void LeaseClient::Run() {
+    while (true) {
+        OSMessage msg;
+        OSReceiveMessage(&mMessageQueue, &msg, OS_MSG_BLOCKING);
+
+        if (mIsExit) {
+            break;
+        }
+
+        Report report;
+        bool acquire;
+
+        {
+            kiwi::AutoMutexLock lock(mMutex);
+
+            report = mReport;
+            mReport.valid = false;
+            acquire = mIsAcquire;
+        }
+
+        // Finished leases go first so the server can reassign them
+        if (report.valid) {
+            Complete(report);
+        }
+
+        if (!acquire) {
+            continue;
+        }
+
+        Lease lease;
+        Acquire(lease);
+
+        {
+            kiwi::AutoMutexLock lock(mMutex);
+
+            if (lease.valid) {
+                mNextLease = lease;
+            }
+
+            mIsAcquire = false;
+        }
+    }
+}
+
+/**
+ * @brief Wakes the worker
+ */
+void LeaseClient::Wake() {
+    // Pending wake-ups already cover this request
+    OSSendMessage(&mMessageQueue, nullptr, 0);
+}
+
+/**
+ * @brief Requests a new lease from the server
+ *
+ * @param[out] rLease New lease
+ * @return Success
+ */
+bool LeaseClient::Acquire(Lease& rLease) {
+    rLease.valid = false;
+
+    // Don't stall every break while the server is unreachable
+    if (OSGetTime() < mRetryTime) {
+        return false;
+    }
+
+    for (int i = 0; i < BreakInfo::WIFI_RETRY_NUM; i++) {
+        kiwi::HttpRequest request("127.0.0.1");
+        request.SetURI("/billiards/api");
+
+        // clang-format off
+        request.SetParameter("action", kiwi::String("lease"));
+        request.SetParameter("user",   *Simulation::GetInstance().GetUniqueID());
+        request.SetParameter("style",  mStyle);
+        // clang-format on
+
+        const kiwi::HttpResponse& rResp = request.Send();
+
+        if (rResp.error != kiwi::EHttpErr_Success ||
+            rResp.status != kiwi::EHttpStatus_OK) {
+            K_LOG_EX("try:%d err:%d ex:%d stat:%d\n", i, rResp.error,
+                     rResp.exError, rResp.status);
+            continue;
+        }
+
+        kiwi::json::Reader reader;
+        reader.Decode(rResp.body);
+
+        const kiwi::json::Element& rRoot = reader.Get();
+        if (rRoot.GetType() != kiwi::json::Element::EType_Object) {
+            K_LOG("Malformed lease response\n");
+            break;
+        }
+
+        const kiwi::json::Object& rObj = rRoot.Get<kiwi::json::Object>();
+        f64 id, start, count, timeout;
+
+        if (!ReadField(rObj, "id", id) || !ReadField(rObj, "start", start) ||
+            !ReadField(rObj, "count", count) ||
+            !ReadField(rObj, "timeout", timeout) || count < 1.0) {
+            break;
+        }
+
+        rLease.valid = true;
+        rLease.id = static_cast<u32>(id);
+        rLease.start = static_cast<u64>(start);
+        rLease.count = static_cast<u32>(count);
+        rLease.taken = 0;
+        rLease.expireTime =
+            OSGetTime() + OS_SEC_TO_TICKS(static_cast<s64>(timeout));
+
+        K_LOG_EX("Lease %u: %llu (+%u)\n", rLease.id, rLease.start,
+                 rLease.count);
+        return true;
+    }
+
+    mRetryTime = OSGetTime() + OS_SEC_TO_TICKS(static_cast<s64>(RETRY_SEC));
+    return false;
+}
+
+/**
+ * @brief Reports the results of a finished lease to the server
+ *
+ * @param rReport Lease results
+ * @return Success
+ */
+bool LeaseClient::Complete(const Report& rReport) {
+    ASSERT(rReport.valid);
+
+    // Ball count distribution as a comma-separated list
+    kiwi::String dist;
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        dist += kiwi::Format(i > 0 ? ",%u" : "%u", rReport.breakBallNum[i]);
+    }
+
+    for (int i = 0; i < BreakInfo::WIFI_RETRY_NUM; i++) {
+        kiwi::HttpRequest request("127.0.0.1");
+        request.SetURI("/billiards/api");
+
+        // clang-format off
+        request.SetParameter("action",  kiwi::String("report"));
+        request.SetParameter("user",    *Simulation::GetInstance().GetUniqueID());
+        request.SetParameter("lease",   rReport.id);
+        request.SetParameter("breaks",  rReport.breakNum);
+        request.SetParameter("dist",    dist);
+        request.SetParameter("qualify", rReport.qualifyNum);
+        // clang-format on
+
+        const kiwi::HttpResponse& rResp = request.Send();
+
+        if (rResp.error == kiwi::EHttpErr_Success &&
+            rResp.status == kiwi::EHttpStatus_OK) {
+            return true;
+        }
+
+        K_LOG_EX("try:%d err:%d ex:%d stat:%d\n", i, rResp.error, rResp.exError,
+                 rResp.status);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Queues the results of the current lease for the worker
+ */
+void LeaseClient::QueueReport() {
+    ASSERT(mCurrLease.valid);
+
+    kiwi::AutoMutexLock lock(mMutex);
+
+    // Server reassigns unreported leases once they expire
+    if (mReport.valid) {
+        K_LOG_EX("Lease %u report dropped\n", mReport.id);
+    }
+
+    mReport.valid = true;
+    mReport.id = mCurrLease.id;
+    mReport.breakNum = mBreakNum;
+    mReport.qualifyNum = mQualifyNum;
+    std::memcpy(mReport.breakBallNum, mBreakBallNum, sizeof(mBreakBallNum));
+
+    Wake();
+}
+
+/**
+ * @brief Clears the results of the current lease
+ */
+void LeaseClient::ClearResults() {
+    mBreakNum = 0;
+    mQualifyNum = 0;
+    std::memset(mBreakBallNum, 0, sizeof(mBreakBallNum));
+}
+
+} // namespace BAH
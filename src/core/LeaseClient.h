@@ -0,0 +1,181 @@
+#ifndef BAH_CLIENT_CORE_LEASE_CLIENT_H
+#define BAH_CLIENT_CORE_LEASE_CLIENT_H
+#include <Pack/RPParty.h>
+#include <libkiwi.h>
+#include <revolution/OS.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Leases blocks of the parameter space from the submission server
+ * @details Each lease is a range of sequence indices that no other client is
+ * given until it expires. Once every index has been simulated, the results
+ * are reported back to the server. Requests are sent by a worker thread, so
+ * the search takes indices from its own range while it waits on the server.
+ */
+class LeaseClient {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param style Randomization style whose space is leased
+     */
+    explicit LeaseClient(u32 style);
+    /**
+     * @brief Destructor
+     * @note Waits for the request in progress to finish
+     */
+    ~LeaseClient();
+
+    /**
+     * @brief Calculates the first index of a user's fallback range
+     * @details Leases are dealt out from the start of the sequence, so the
+     * indices a client takes on its own come from far beyond them.
+     *
+     * @param user User unique ID
+     */
+    static u64 GetFallbackBase(u32 user) {
+        return FALLBACK_BASE + (static_cast<u64>(user) << FALLBACK_SHIFT);
+    }
+
+    /**
+     * @brief Takes the next sequence index from the current lease
+     *
+     * @return Sequence index, or none if no lease is ready yet
+     */
+    kiwi::Optional<u64> Next();
+
+    /**
+     * @brief Records the results of a break from the current lease
+     *
+     * @param ballNum Balls sunk or off the table
+     * @param qualify Whether the break was uploaded
+     */
+    void Record(u32 ballNum, bool qualify);
+
+    /**
+     * @brief Deserializes the current lease and its results from stream
+     *
+     * @param rStrm Stream
+     */
+    void Read(kiwi::MemStream& rStrm);
+    /**
+     * @brief Serializes the current lease and its results to stream
+     * @note The prefetched lease is not kept, the server reassigns it once
+     * it expires
+     *
+     * @param rStrm Stream
+     */
+    void Write(kiwi::MemStream& rStrm) const;
+
+private:
+    /**
+     * @brief Leased block of the parameter space
+     */
+    struct Lease {
+        bool valid;     //!< Whether the lease is held
+        u32 id;         //!< Server-side lease ID
+        u64 start;      //!< First sequence index
+        u32 count;      //!< Number of sequence indices
+        u32 taken;      //!< Number of sequence indices handed out
+        s64 expireTime; //!< Time at which the server reassigns the lease
+    };
+
+    /**
+     * @brief Results of a finished lease
+     */
+    struct Report {
+        bool valid;                                   //!< Waiting to be sent
+        u32 id;                                       //!< Server-side lease ID
+        u32 breakNum;                                 //!< Breaks simulated
+        u32 breakBallNum[RPBilBallManager::BALL_MAX]; //!< Breaks by ball count
+        u32 qualifyNum;                               //!< Breaks uploaded
+    };
+
+    //! Seconds to wait before leasing again after a failure
+    static const u32 RETRY_SEC = 60;
+    //! Fraction (1/x) of the current lease left when the next is leased
+    static const u32 PREFETCH_DIV = 4;
+
+    //! First index of the fallback ranges (never reached by leases)
+    static const u64 FALLBACK_BASE = 1ULL << 63;
+    //! Size (log2) of each user's fallback range
+    static const u32 FALLBACK_SHIFT = 31;
+
+    //! Maximum number of pending worker wake-ups
+    static const u32 MESSAGE_MAX = 4;
+
+private:
+    /**
+     * @brief Worker thread function
+     */
+    void Run();
+    /**
+     * @brief Wakes the worker
+     */
+    void Wake();
+
+    /**
+     * @brief Requests a new lease from the server
+     *
+     * @param[out] rLease New lease
+     * @return Success
+     */
+    bool Acquire(Lease& rLease);
+    /**
+     * @brief Reports the results of a finished lease to the server
+     *
+     * @param rReport Lease results
+     * @return Success
+     */
+    bool Complete(const Report& rReport);
+
+    /**
+     * @brief Queues the results of the current lease for the worker
+     */
+    void QueueReport();
+    /**
+     * @brief Clears the results of the current lease
+     */
+    void ClearResults();
+
+private:
+    //! Randomization style whose space is leased
+    u32 mStyle;
+
+    //! Lease being simulated
+    Lease mCurrLease;
+    //! Lease to simulate next (filled in by the worker)
+    Lease mNextLease;
+    //! Whether the worker should lease the next block
+    bool mIsAcquire;
+    //! Results waiting to be reported by the worker
+    Report mReport;
+
+    //! Time before which no lease is requested (worker only)
+    s64 mRetryTime;
+
+    //! Guards the next lease, the request flag, and the queued report
+    OSMutex mMutex;
+    //! Wakes the worker
+    OSMessageQueue mMessageQueue;
+    //! Message queue storage
+    OSMessage mMessages[MESSAGE_MAX];
+    //! Whether the worker should stop
+    volatile bool mIsExit;
+
+    //! Server request worker
+    kiwi::Thread* mpThread;
+
+    //! Breaks simulated from the current lease
+    u32 mBreakNum;
+    //! Breaks simulated from the current lease by ball count
+    u32 mBreakBallNum[RPBilBallManager::BALL_MAX];
+    //! Breaks uploaded from the current lease
+    u32 mQualifyNum;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,196 @@
+#include "core/LocalSearch.h"
+
+#include <libkiwi.h>
+
+#include <cmath>
+
+namespace BAH {
+namespace {
+
+//! Euler's number (there is no exp in the game's math library)
+const f64 E = 2.718281828459045;
+
+} // namespace
+
+//! Starting temperature (in score units)
+const f32 LocalSearch::TEMP_START = 1.0f;
+//! Temperature below which the search restarts
+const f32 LocalSearch::TEMP_MIN = 0.01f;
+//! Temperature multiplier per candidate
+const f32 LocalSearch::COOLING = 0.995f;
+
+//! Minimum perturbation scale
+const f32 LocalSearch::SCALE_MIN = 0.1f;
+//! Maximum perturbation scale
+const f32 LocalSearch::SCALE_MAX = 4.0f;
+
+/**
+ * @brief Constructor
+ *
+ * @param ratio Fraction of breaks spent searching locally
+ * @param powerMin Minimum cue power
+ * @param powerMax Maximum cue power
+ */
+LocalSearch::LocalSearch(f32 ratio, f32 powerMin, f32 powerMax)
+    : mRatio(ratio),
+      mPowerMin(powerMin),
+      mPowerMax(powerMax),
+      mIsEnabled(ratio > 0.0f),
+      mHasCenter(false),
+      mTemp(TEMP_START),
+      mScale(1.0f) {}
+
+/**
+ * @brief Starts searching around a new break
+ *
+ * @param rBreak Break to search around
+ */
+void LocalSearch::SetCenter(const BreakInfo& rBreak) {
+    mCenter = rBreak;
+    mOrigin = rBreak;
+    mHasCenter = true;
+
+    mTemp = TEMP_START;
+    mScale = 1.0f;
+}
+
+/**
+ * @brief Decides whether the next break searches locally
+ */
+bool LocalSearch::Roll() {
+    if (!mIsEnabled || !mHasCenter) {
+        return false;
+    }
+
+    return mRandom.NextF32() < mRatio;
+}
+
+/**
+ * @brief Perturbs the center into a new candidate
+ *
+ * @param[out] rBreak Candidate break (aiming and hit)
+ */
+void LocalSearch::Propose(BreakInfo& rBreak) {
+    ASSERT(mHasCenter);
+
+    rBreak.kseed = mRandom.GetSeed();
+
+    // Sideways aiming is one axis (negative for left)
+    f32 up = Perturb(static_cast<f32>(mCenter.up), 2.0f, 0.0f, 55.0f);
+    f32 side = Perturb(static_cast<f32>(mCenter.right - mCenter.left), 1.5f,
+                       -12.0f, 12.0f);
+
+    rBreak.up = static_cast<s32>(up + 0.5f);
+
+    s32 frames = static_cast<s32>(side < 0.0f ? side - 0.5f : side + 0.5f);
+    rBreak.left = frames < 0 ? -frames : 0;
+    rBreak.right = frames > 0 ? frames : 0;
+
+    rBreak.pos.x = Perturb(mCenter.pos.x, 0.002f, -0.015f, 0.015f);
+    rBreak.pos.y = Perturb(mCenter.pos.y, 0.01f, 0.15f, 0.35f);
+    rBreak.power = Perturb(mCenter.power, 5.0f, mPowerMin, mPowerMax);
+}
+
+/**
+ * @brief Updates the center with a candidate's results
+ *
+ * @param rBreak Candidate break
+ */
+void LocalSearch::Accept(const BreakInfo& rBreak) {
+    ASSERT(mHasCenter);
+
+    // Only compare near misses when both breaks have one (loaded breaks
+    // and pruned breaks do not)
+    bool nearMiss = rBreak.nearMiss >= 0.0f && mCenter.nearMiss >= 0.0f;
+
+    f32 score = Score(rBreak, nearMiss);
+    f32 centerScore = Score(mCenter, nearMiss);
+    bool better = rBreak.IsBetterThan(mCenter);
+
+    // Worse breaks are accepted less often as the search cools down
+    f64 chance = std::pow(E, static_cast<f64>((score - centerScore) / mTemp));
+    bool accept = better || score >= centerScore || mRandom.NextF32() < chance;
+
+    if (accept) {
+        mCenter = rBreak;
+    }
+
+    // Balanced when one in five candidates improves (1.5 * 0.9^4 ~= 1)
+    mScale = better ? kiwi::Min(mScale * 1.5f, SCALE_MAX)
+                    : kiwi::Max(mScale * 0.9f, SCALE_MIN);
+
+    mTemp *= COOLING;
+
+    // Frozen, so start over from the original break
+    if (mTemp < TEMP_MIN) {
+        mCenter = mOrigin;
+        mTemp = TEMP_START;
+        mScale = 1.0f;
+    }
+}
+
+/**
+ * @brief Deserializes search state from stream
+ *
+ * @param rStrm Stream
+ */
+void LocalSearch::Read(kiwi::MemStream& rStrm) {
+    mIsEnabled = rStrm.Read_bool();
+    mHasCenter = rStrm.Read_bool();
+    mCenter.Read(rStrm);
+    mOrigin.Read(rStrm);
+    mTemp = rStrm.Read_f32();
+    mScale = rStrm.Read_f32();
+    mRandom.SetSeed(rStrm.Read_u32());
+}
+
+/**
+ * @brief Serializes search state to stream
+ *
+ * @param rStrm Stream
+ */
+void LocalSearch::Write(kiwi::MemStream& rStrm) const {
+    rStrm.Write_bool(mIsEnabled);
+    rStrm.Write_bool(mHasCenter);
+    mCenter.Write(rStrm);
+    mOrigin.Write(rStrm);
+    rStrm.Write_f32(mTemp);
+    rStrm.Write_f32(mScale);
+    rStrm.Write_u32(mRandom.GetSeed());
+}
+
+/**
+ * @brief Calculates the secondary score of a break
+ *
+ * @param rBreak Break
+ * @param nearMiss Whether near misses are scored
+ */
+f32 LocalSearch::Score(const BreakInfo& rBreak, bool nearMiss) {
+    f32 score = static_cast<f32>(rBreak.sunk + rBreak.off);
+
+    // Same preferences as BreakInfo::IsBetterThan
+    score += 0.25f * rBreak.sunk;
+    score -= rBreak.foul ? 0.5f : 0.0f;
+
+    // Near misses break ties, but never outweigh an extra ball sunk
+    if (nearMiss) {
+        score += 0.02f * rBreak.nearMiss;
+    }
+
+    return score;
+}
+
+/**
+ * @brief Perturbs a value within bounds
+ *
+ * @param value Original value
+ * @param radius Maximum perturbation
+ * @param min Lower bound
+ * @param max Upper bound
+ */
+f32 LocalSearch::Perturb(f32 value, f32 radius, f32 min, f32 max) {
+    value += (mRandom.NextF32(2.0f) - 1.0f) * radius * mScale;
+    return kiwi::Clamp(value, min, max);
+}
+
+} // namespace BAH
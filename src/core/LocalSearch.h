@@ -0,0 +1,156 @@
+#ifndef BAH_CLIENT_CORE_LOCAL_SEARCH_H
+#define BAH_CLIENT_CORE_LOCAL_SEARCH_H
+#include "core/BreakInfo.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Simulated annealing around a good break
+ * @details Candidates perturb the aiming and hit of the current center. Better
+ * results always become the new center, while worse results are accepted with
+ * a probability that falls as the search cools down. The perturbation size
+ * grows after successes and shrinks after failures.
+ */
+class LocalSearch {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param ratio Fraction of breaks spent searching locally
+     * @param powerMin Minimum cue power
+     * @param powerMax Maximum cue power
+     */
+    LocalSearch(f32 ratio, f32 powerMin, f32 powerMax);
+
+    /**
+     * @brief Starts searching around a new break
+     *
+     * @param rBreak Break to search around
+     */
+    void SetCenter(const BreakInfo& rBreak);
+
+    /**
+     * @brief Tests whether the search has a break to search around
+     */
+    bool HasCenter() const {
+        return mHasCenter;
+    }
+
+    /**
+     * @brief Tests whether the search is turned on
+     */
+    bool IsEnabled() const {
+        return mIsEnabled;
+    }
+    /**
+     * @brief Turns the search on or off
+     *
+     * @param enable Whether the search should be used
+     */
+    void SetEnabled(bool enable) {
+        mIsEnabled = enable;
+    }
+
+    /**
+     * @brief Decides whether the next break searches locally
+     */
+    bool Roll();
+
+    /**
+     * @brief Perturbs the center into a new candidate
+     *
+     * @param[out] rBreak Candidate break (aiming and hit)
+     */
+    void Propose(BreakInfo& rBreak);
+    /**
+     * @brief Updates the center with a candidate's results
+     *
+     * @param rBreak Candidate break
+     */
+    void Accept(const BreakInfo& rBreak);
+
+    /**
+     * @brief Accesses the center break
+     */
+    const BreakInfo& GetCenter() const {
+        return mCenter;
+    }
+
+    /**
+     * @brief Deserializes search state from stream
+     *
+     * @param rStrm Stream
+     */
+    void Read(kiwi::MemStream& rStrm);
+    /**
+     * @brief Serializes search state to stream
+     *
+     * @param rStrm Stream
+     */
+    void Write(kiwi::MemStream& rStrm) const;
+
+private:
+    //! Starting temperature (in score units)
+    static const f32 TEMP_START;
+    //! Temperature below which the search restarts
+    static const f32 TEMP_MIN;
+    //! Temperature multiplier per candidate
+    static const f32 COOLING;
+
+    //! Minimum perturbation scale
+    static const f32 SCALE_MIN;
+    //! Maximum perturbation scale
+    static const f32 SCALE_MAX;
+
+private:
+    /**
+     * @brief Calculates the secondary score of a break
+     *
+     * @param rBreak Break
+     * @param nearMiss Whether near misses are scored
+     */
+    static f32 Score(const BreakInfo& rBreak, bool nearMiss);
+
+    /**
+     * @brief Perturbs a value within bounds
+     *
+     * @param value Original value
+     * @param radius Maximum perturbation
+     * @param min Lower bound
+     * @param max Upper bound
+     */
+    f32 Perturb(f32 value, f32 radius, f32 min, f32 max);
+
+private:
+    //! Fraction of breaks spent searching locally
+    f32 mRatio;
+    //! Minimum cue power
+    f32 mPowerMin;
+    //! Maximum cue power
+    f32 mPowerMax;
+
+    //! Whether the search is turned on
+    bool mIsEnabled;
+
+    //! Break being searched around
+    BreakInfo mCenter;
+    //! Break the search started from
+    BreakInfo mOrigin;
+    //! Whether there is a break to search around
+    bool mHasCenter;
+
+    //! Current temperature
+    f32 mTemp;
+    //! Current perturbation scale
+    f32 mScale;
+
+    //! Random generator
+    kiwi::Random mRandom;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,80 @@
+#include "core/MotionPruner.h"
+
+#include <Pack/RPParty.h>
+
+#include <libkiwi.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param epsilon Speed below which a ball is considered stopped
+ * @param chain Resting balls each moving ball may knock in (zero for no
+ * limit)
+ */
+MotionPruner::MotionPruner(f32 epsilon, u32 chain)
+    : mEpsilonSq(epsilon * epsilon), mChain(chain), mIsShot(false) {}
+
+/**
+ * @brief Prepares the pruner for a new break
+ */
+void MotionPruner::Reset() {
+    mIsShot = false;
+}
+
+/**
+ * @brief Calculates an upper bound on the final ball count (sunk + off)
+ *
+ * @return Ball count bound, or none if it cannot be known yet
+ */
+kiwi::Optional<u32> MotionPruner::CalcBound() {
+    RPBilBall* pCueBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(0);
+    ASSERT(pCueBall != nullptr);
+    ASSERT(pCueBall->IsCueBall());
+
+    bool cueMoving = pCueBall->IsState(RPBilBall::EState_Wait) &&
+                     pCueBall->GetVelocity().squaredLength() > mEpsilonSq;
+
+    // Nothing to bound until the cue ball has been hit and stopped
+    if (cueMoving) {
+        mIsShot = true;
+    }
+
+    if (!mIsShot || cueMoving) {
+        return kiwi::nullopt;
+    }
+
+    u32 doneNum = 0;
+    u32 movingNum = 0;
+    u32 restingNum = 0;
+
+    for (int i = 1; i < RPBilBallManager::BALL_MAX; i++) {
+        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
+        ASSERT(pBall != nullptr);
+
+        // Already counted (or still falling in)
+        if (!pBall->IsState(RPBilBall::EState_Wait)) {
+            doneNum++;
+            continue;
+        }
+
+        if (pBall->GetVelocity().squaredLength() > mEpsilonSq) {
+            movingNum++;
+        } else {
+            restingNum++;
+        }
+    }
+
+    // Any resting ball may still be hit while something moves
+    u32 hitNum = movingNum > 0 ? restingNum : 0;
+
+    // Tighter, but only a guess
+    if (mChain > 0) {
+        hitNum = kiwi::Min(hitNum, movingNum * mChain);
+    }
+
+    return doneNum + movingNum + hitNum;
+}
+
+} // namespace BAH
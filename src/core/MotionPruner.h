@@ -0,0 +1,52 @@
+#ifndef BAH_CLIENT_CORE_MOTION_PRUNER_H
+#define BAH_CLIENT_CORE_MOTION_PRUNER_H
+#include "core/IBreakPruner.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Prunes breaks by the number of balls still in motion
+ * @details Once the cue ball has stopped, only moving balls (and the balls
+ * they may knock in) can add to the result. Without a chain limit the bound
+ * is safe: any resting ball may still be hit while something moves. A chain
+ * limit is a guess that should be checked with pruneValidate.
+ */
+class MotionPruner : public IBreakPruner {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param epsilon Speed below which a ball is considered stopped
+     * @param chain Resting balls each moving ball may knock in (zero for no
+     * limit)
+     */
+    MotionPruner(f32 epsilon, u32 chain);
+
+    /**
+     * @brief Prepares the pruner for a new break
+     */
+    virtual void Reset();
+
+    /**
+     * @brief Calculates an upper bound on the final ball count (sunk + off)
+     *
+     * @return Ball count bound, or none if it cannot be known yet
+     */
+    virtual kiwi::Optional<u32> CalcBound();
+
+private:
+    //! Squared speed below which a ball is considered stopped
+    f32 mEpsilonSq;
+    //! Resting balls each moving ball may knock in (zero for no limit)
+    u32 mChain;
+
+    //! Whether the cue ball has been hit yet
+    bool mIsShot;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,77 @@
+#include "core/NandUtil.h"
+
+#include "core/BreakInfo.h"
+#include "core/Config.h"
+#include "core/NandWriter.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+namespace BAH {
+
+/**
+ * @brief Writes a buffer to a NAND file, retrying while the NAND is busy
+ *
+ * @param rName File name
+ * @param rBuffer File contents
+ */
+void WriteNandFile(const kiwi::String& rName, const kiwi::WorkBuffer& rBuffer) {
+    WriteNandFile(rName, rBuffer, rBuffer.AlignedSize());
+}
+
+/**
+ * @brief Writes data to a NAND file, retrying while the NAND is busy
+ *
+ * @param rName File name
+ * @param pData File contents (32-byte aligned)
+ * @param size File size (32-byte aligned)
+ */
+void WriteNandFile(const kiwi::String& rName, const void* pData, u32 size) {
+    WriteNandFile(rName, pData, size, 0);
+}
+
+/**
+ * @brief Writes data into a NAND file at an offset, retrying while the NAND
+ * is busy
+ *
+ * @param rName File name
+ * @param pData Data (32-byte aligned)
+ * @param size Data size (32-byte aligned)
+ * @param offset File offset (no further than the end of the file)
+ */
+void WriteNandFile(const kiwi::String& rName, const void* pData, u32 size,
+                   u32 offset) {
+    ASSERT(pData != nullptr);
+
+    // Never write around the queue, or an older write could land afterwards.
+    // Waiting for it instead could take the whole retry budget.
+    bool queue = Config::GetInstance().IsNandAsync() ||
+                 NandWriter::GetInstance().IsBusy();
+
+    // Resort lacks the asynchronous functions, so nothing can be queued there
+    if (queue && NandWriter::GetInstance().Write(rName, pData, size, offset)) {
+        return;
+    }
+
+    kiwi::NandStream strm(kiwi::EOpenMode_Write);
+
+    for (int i = 0; i < BreakInfo::NAND_RETRY_NUM; i++) {
+        // Attempt to open file
+        if (strm.Open(rName)) {
+            break;
+        }
+
+        // Failed? Try again in one second
+        OSSleepTicks(OS_SEC_TO_TICKS(1));
+    }
+
+    ASSERT_EX(strm.IsOpen(), "NAND error");
+
+    if (offset > 0) {
+        strm.Seek(kiwi::ESeekDir_Begin, offset);
+    }
+
+    strm.Write(pData, size);
+}
+
+} // namespace BAH
@@ -0,0 +1,37 @@
+#ifndef BAH_CLIENT_CORE_NAND_UTIL_H
+#define BAH_CLIENT_CORE_NAND_UTIL_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Writes a buffer to a NAND file, retrying while the NAND is busy
+ *
+ * @param rName File name
+ * @param rBuffer File contents
+ */
+void WriteNandFile(const kiwi::String& rName, const kiwi::WorkBuffer& rBuffer);
+/**
+ * @brief Writes data to a NAND file, retrying while the NAND is busy
+ *
+ * @param rName File name
+ * @param pData File contents (32-byte aligned)
+ * @param size File size (32-byte aligned)
+ */
+void WriteNandFile(const kiwi::String& rName, const void* pData, u32 size);
+/**
+ * @brief Writes data into a NAND file at an offset, retrying while the NAND
+ * is busy
+ *
+ * @param rName File name
+ * @param pData Data (32-byte aligned)
+ * @param size Data size (32-byte aligned)
+ * @param offset File offset (no further than the end of the file)
+ */
+void WriteNandFile(const kiwi::String& rName, const void* pData, u32 size,
+                   u32 offset);
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,464 @@
+#include "core/NandWriter.h"
+
+#include <libkiwi.h>
+#include <revolution/NAND.h>
+#include <revolution/OS.h>
+
+#include <cstring>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ */
+NandWriter::NandWriter()
+    : mStream(kiwi::EOpenMode_Write),
+      mpActive(nullptr),
+      mStep(EStep_Open),
+      mFailNum(0),
+      mNextSequence(0),
+      mResult(0),
+      mIsKickPending(false),
+      mpThread(nullptr) {
+
+    OSCreateAlarm(&mAlarm);
+    OSInitMessageQueue(&mMessageQueue, mMessages, MESSAGE_MAX);
+
+    for (int i = 0; i < JOB_MAX; i++) {
+        mJobs[i].pBuffer = nullptr;
+        mJobs[i].capacity = 0;
+        mJobs[i].size = 0;
+        mJobs[i].offset = 0;
+        mJobs[i].sequence = 0;
+        mJobs[i].state = EJobState_Free;
+    }
+
+    // Worker starts immediately, so everything else must be ready
+    mpThread =
+        new (32, kiwi::EMemory_MEM2) kiwi::Thread(&NandWriter::Run, *this);
+    ASSERT(mpThread != nullptr);
+}
+
+/**
+ * @brief Queues data to be written into a NAND file
+ * @note A queued write of the same file region is replaced. When the queue
+ * is full, this waits for the oldest write to finish.
+ *
+ * @param rName File name
+ * @param pData Data (copied, so it may be reused immediately)
+ * @param size Data size (32-byte aligned)
+ * @param offset File offset (no further than the end of the file)
+ * @return Whether the write was queued (false when writes are unsupported)
+ */
+bool NandWriter::Write(const kiwi::String& rName, const void* pData, u32 size,
+                       u32 offset) {
+#if defined(PACK_RESORT)
+#pragma unused(rName)
+#pragma unused(pData)
+#pragma unused(size)
+#pragma unused(offset)
+
+    // Resort lacks the asynchronous create/write functions
+    return false;
+#else
+    ASSERT(pData != nullptr);
+    ASSERT(size > 0);
+
+    Job* pJob = nullptr;
+    bool replace = false;
+
+    // Wait for the writer rather than writing around it, so the queue order
+    // is always the order the data reaches the file
+    while (true) {
+        {
+            kiwi::AutoInterruptLock lock;
+
+            // Newer data makes the queued copy obsolete
+            pJob = FindPending(rName, offset, size);
+            replace = pJob != nullptr;
+
+            for (int i = 0; pJob == nullptr && i < JOB_MAX; i++) {
+                if (mJobs[i].state == EJobState_Free) {
+                    pJob = &mJobs[i];
+                }
+            }
+
+            if (pJob != nullptr) {
+                // Keep the writer away until the copy is complete
+                pJob->state = EJobState_Reserved;
+                break;
+            }
+        }
+
+        OSSleepTicks(OS_MSEC_TO_TICKS(static_cast<s64>(WAIT_MSEC)));
+    }
+
+    if (!replace) {
+        // Buffers are only ever (re)allocated here, never in callbacks
+        if (pJob->capacity < size) {
+            delete[] pJob->pBuffer;
+            pJob->pBuffer = new (32, kiwi::EMemory_MEM2) u8[size];
+            ASSERT(pJob->pBuffer != nullptr);
+            pJob->capacity = size;
+        }
+
+        pJob->name = rName;
+        pJob->size = size;
+        pJob->offset = offset;
+        pJob->sequence = mNextSequence++;
+    }
+
+    std::memcpy(pJob->pBuffer, pData, size);
+
+    {
+        kiwi::AutoInterruptLock lock;
+        pJob->state = EJobState_Pending;
+    }
+
+    Wake();
+    return true;
+#endif
+}
+
+/**
+ * @brief Tests whether any write has not finished yet
+ */
+bool NandWriter::IsBusy() const {
+    kiwi::AutoInterruptLock lock;
+
+    for (int i = 0; i < JOB_MAX; i++) {
+        if (mJobs[i].state != EJobState_Free) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Waits until every queued write has finished
+ */
+void NandWriter::Flush() const {
+    while (IsBusy()) {
+        OSSleepTicks(OS_MSEC_TO_TICKS(static_cast<s64>(WAIT_MSEC)));
+    }
+}
+
+/**
+ * @brief Worker thread function
+ */
+void NandWriter::Run() {
+    while (true) {
+        OSMessage msg;
+        OSReceiveMessage(&mMessageQueue, &msg, OS_MSG_BLOCKING);
+
+        switch (reinterpret_cast<u32>(msg)) {
+        case EEvent_Kick: {
+            {
+                kiwi::AutoInterruptLock lock;
+                mIsKickPending = false;
+            }
+
+            Kick();
+            break;
+        }
+
+        case EEvent_Step: {
+            Step(mResult);
+            break;
+        }
+
+        case EEvent_Retry: {
+            Start();
+            break;
+        }
+
+        default: {
+            ASSERT(false);
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief Wakes the worker to start the next queued write
+ * @note At most one wake-up is pending at a time
+ */
+void NandWriter::Wake() {
+    {
+        kiwi::AutoInterruptLock lock;
+
+        if (mIsKickPending) {
+            return;
+        }
+
+        mIsKickPending = true;
+    }
+
+    Post(EEvent_Kick);
+}
+
+/**
+ * @brief Sends an event to the worker (safe in interrupt context)
+ *
+ * @param event Event
+ */
+void NandWriter::Post(EEvent event) {
+    // One kick and one completion at most, so this always fits
+    BOOL success = OSSendMessage(
+        &mMessageQueue, reinterpret_cast<OSMessage>(static_cast<u32>(event)),
+        0);
+    ASSERT(success);
+}
+
+/**
+ * @brief Finds a queued write of the same file region
+ *
+ * @param rName File name
+ * @param offset File offset
+ * @param size Data size
+ */
+NandWriter::Job* NandWriter::FindPending(const kiwi::String& rName,
+                                         u32 offset, u32 size) {
+    for (int i = 0; i < JOB_MAX; i++) {
+        Job& rJob = mJobs[i];
+
+        if (rJob.state != EJobState_Pending) {
+            continue;
+        }
+
+        if (rJob.offset == offset && rJob.size == size && rJob.name == rName) {
+            return &rJob;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Starts the oldest queued write if the writer is idle
+ */
+void NandWriter::Kick() {
+    {
+        kiwi::AutoInterruptLock lock;
+
+        if (mpActive != nullptr) {
+            return;
+        }
+
+        Job* pNext = nullptr;
+
+        for (int i = 0; i < JOB_MAX; i++) {
+            Job& rJob = mJobs[i];
+
+            if (rJob.state != EJobState_Pending) {
+                continue;
+            }
+
+            if (pNext == nullptr || rJob.sequence < pNext->sequence) {
+                pNext = &rJob;
+            }
+        }
+
+        if (pNext == nullptr) {
+            return;
+        }
+
+        pNext->state = EJobState_Active;
+        mpActive = pNext;
+        mFailNum = 0;
+    }
+
+    Start();
+}
+
+/**
+ * @brief Starts (or restarts) the active job
+ */
+void NandWriter::Start() {
+    ASSERT(mpActive != nullptr);
+
+    mStep = EStep_Open;
+
+    if (!mStream.OpenAsync(mpActive->name, StepCallbackFunc)) {
+        Fail();
+    }
+}
+
+/**
+ * @brief Advances the active job after a NAND operation completes
+ *
+ * @param result NAND result code
+ */
+void NandWriter::Step(s32 result) {
+    ASSERT(mpActive != nullptr);
+
+    bool success = false;
+
+    switch (mStep) {
+    case EStep_Open: {
+        // Write mode should create missing files, like NandStream::Open
+        if (result == NAND_RESULT_NOEXISTS) {
+            mStep = EStep_Create;
+            success = mStream.CreateAsync(mpActive->name, StepCallbackFunc);
+            break;
+        }
+
+        if (result != NAND_RESULT_OK) {
+            break;
+        }
+
+        mStep = EStep_Seek;
+        success = mStream.SeekAsync(kiwi::ESeekDir_Begin, mpActive->offset,
+                                    StepCallbackFunc);
+        break;
+    }
+
+    case EStep_Create: {
+        // Someone else may have created it in the meantime
+        if (result != NAND_RESULT_OK && result != NAND_RESULT_EXISTS) {
+            break;
+        }
+
+        mStep = EStep_Open;
+        success = mStream.OpenAsync(mpActive->name, StepCallbackFunc);
+        break;
+    }
+
+    case EStep_Seek: {
+        // Result is the new file position
+        if (result < 0) {
+            break;
+        }
+
+        mStep = EStep_Write;
+        success = mStream.WriteAsync(mpActive->pBuffer, mpActive->size,
+                                     StepCallbackFunc);
+        break;
+    }
+
+    case EStep_Write: {
+        if (result != static_cast<s32>(mpActive->size)) {
+            break;
+        }
+
+        mStep = EStep_Close;
+        success = mStream.CloseAsync(StepCallbackFunc);
+        break;
+    }
+
+    case EStep_Close: {
+        // Data is only committed once the file is closed
+        if (result != NAND_RESULT_OK) {
+            break;
+        }
+
+        Finish();
+        return;
+    }
+
+    case EStep_Abort: {
+        Retry();
+        return;
+    }
+
+    default: {
+        ASSERT(false);
+        break;
+    }
+    }
+
+    if (!success) {
+        K_LOG_EX("NAND write step %d failed (%d)\n", mStep, result);
+        Fail();
+    }
+}
+
+/**
+ * @brief Handles a failed step of the active job
+ */
+void NandWriter::Fail() {
+    ASSERT(mpActive != nullptr);
+
+    mFailNum++;
+
+    // Release the file handle before waiting
+    if (mStream.IsOpen()) {
+        mStep = EStep_Abort;
+
+        if (mStream.CloseAsync(StepCallbackFunc)) {
+            return;
+        }
+    }
+
+    Retry();
+}
+
+/**
+ * @brief Schedules another attempt, or gives up on the active job
+ */
+void NandWriter::Retry() {
+    ASSERT(mpActive != nullptr);
+
+    if (mFailNum >= RETRY_MAX) {
+        K_LOG_EX("Giving up on writing %s\n", mpActive->name.CStr());
+        Finish();
+        return;
+    }
+
+    // Double the delay after each failure
+    u32 msec = RETRY_MSEC_MIN << (mFailNum - 1);
+    if (msec > RETRY_MSEC_MAX) {
+        msec = RETRY_MSEC_MAX;
+    }
+
+    OSSetAlarm(&mAlarm, OS_MSEC_TO_TICKS(static_cast<s64>(msec)),
+               AlarmCallbackFunc);
+}
+
+/**
+ * @brief Releases the active job and moves on to the next one
+ */
+void NandWriter::Finish() {
+    ASSERT(mpActive != nullptr);
+
+    {
+        kiwi::AutoInterruptLock lock;
+
+        // Buffer is kept for the next job in this slot
+        mpActive->state = EJobState_Free;
+        mpActive = nullptr;
+    }
+
+    Kick();
+}
+
+/**
+ * @brief NAND operation completion handler (interrupt context)
+ *
+ * @param result NAND result code
+ * @param pArg Callback user argument
+ */
+void NandWriter::StepCallbackFunc(s32 result, void* pArg) {
+#pragma unused(pArg)
+
+    // Only one operation is in flight, so the result cannot be overwritten
+    GetInstance().mResult = result;
+    GetInstance().Post(EEvent_Step);
+}
+
+/**
+ * @brief Retry alarm handler (interrupt context)
+ *
+ * @param pAlarm OS alarm
+ * @param pCtx Alarm context
+ */
+void NandWriter::AlarmCallbackFunc(OSAlarm* pAlarm, OSContext* pCtx) {
+#pragma unused(pAlarm)
+#pragma unused(pCtx)
+
+    GetInstance().Post(EEvent_Retry);
+}
+
+} // namespace BAH
@@ -0,0 +1,208 @@
+#ifndef BAH_CLIENT_CORE_NAND_WRITER_H
+#define BAH_CLIENT_CORE_NAND_WRITER_H
+#include <libkiwi.h>
+#include <revolution/OS.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Background NAND file writer
+ * @details Writes are copied into a small queue and performed one at a time
+ * by a worker thread, so the caller only waits when the queue is full. The
+ * worker drives each write with asynchronous NAND operations. Their
+ * completion callbacks and the retry alarm run in interrupt context, so they
+ * only hand the result to the worker through its message queue. Failed writes
+ * are retried after an increasing delay.
+ */
+class NandWriter : public kiwi::StaticSingleton<NandWriter> {
+    friend class kiwi::StaticSingleton<NandWriter>;
+
+public:
+    /**
+     * @brief Queues data to be written into a NAND file
+     * @note A queued write of the same file region is replaced. When the
+     * queue is full, this waits for the oldest write to finish.
+     *
+     * @param rName File name
+     * @param pData Data (copied, so it may be reused immediately)
+     * @param size Data size (32-byte aligned)
+     * @param offset File offset (no further than the end of the file)
+     * @return Whether the write was queued (false when writes are
+     * unsupported)
+     */
+    bool Write(const kiwi::String& rName, const void* pData, u32 size,
+               u32 offset);
+
+    /**
+     * @brief Tests whether any write has not finished yet
+     */
+    bool IsBusy() const;
+    /**
+     * @brief Waits until every queued write has finished
+     */
+    void Flush() const;
+
+private:
+    //! Maximum number of queued writes
+    static const int JOB_MAX = 8;
+    //! Number of failed attempts before a write is abandoned
+    static const int RETRY_MAX = 10;
+    //! Delay before the first retry (in milliseconds)
+    static const u32 RETRY_MSEC_MIN = 250;
+    //! Longest delay between retries (in milliseconds)
+    static const u32 RETRY_MSEC_MAX = 8000;
+    //! Polling interval while waiting on the queue (in milliseconds)
+    static const u32 WAIT_MSEC = 10;
+    //! Maximum number of pending worker wake-ups
+    static const int MESSAGE_MAX = 4;
+
+    /**
+     * @brief Reason the worker was woken up
+     */
+    enum EEvent {
+        EEvent_Kick,  //!< A write was queued
+        EEvent_Step,  //!< A NAND operation completed
+        EEvent_Retry  //!< The retry delay has passed
+    };
+
+    /**
+     * @brief Write job state
+     */
+    enum EJobState {
+        EJobState_Free,     //!< Slot can be reused
+        EJobState_Reserved, //!< Caller is filling in the data
+        EJobState_Pending,  //!< Waiting in the queue
+        EJobState_Active    //!< Being written
+    };
+
+    /**
+     * @brief Current step of the active job
+     */
+    enum EStep {
+        EStep_Open,   //!< Opening the file
+        EStep_Create, //!< Creating the missing file
+        EStep_Seek,   //!< Seeking to the write offset
+        EStep_Write,  //!< Writing the data
+        EStep_Close,  //!< Closing the file after writing
+        EStep_Abort   //!< Closing the file after a failure
+    };
+
+    /**
+     * @brief Queued write
+     */
+    struct Job {
+        kiwi::String name; //!< File name
+        u8* pBuffer;       //!< Copy of the data (owned)
+        u32 capacity;      //!< Buffer size
+        u32 size;          //!< Data size
+        u32 offset;        //!< File offset
+        u32 sequence;      //!< Queue order
+        EJobState state;   //!< Job state
+    };
+
+private:
+    /**
+     * @brief Constructor
+     */
+    NandWriter();
+
+    /**
+     * @brief Worker thread function
+     */
+    void Run();
+    /**
+     * @brief Wakes the worker to start the next queued write
+     * @note At most one wake-up is pending at a time
+     */
+    void Wake();
+    /**
+     * @brief Sends an event to the worker (safe in interrupt context)
+     *
+     * @param event Event
+     */
+    void Post(EEvent event);
+
+    /**
+     * @brief Finds a queued write of the same file region
+     *
+     * @param rName File name
+     * @param offset File offset
+     * @param size Data size
+     */
+    Job* FindPending(const kiwi::String& rName, u32 offset, u32 size);
+    /**
+     * @brief Starts the oldest queued write if the writer is idle
+     */
+    void Kick();
+    /**
+     * @brief Starts (or restarts) the active job
+     */
+    void Start();
+    /**
+     * @brief Advances the active job after a NAND operation completes
+     *
+     * @param result NAND result code
+     */
+    void Step(s32 result);
+    /**
+     * @brief Handles a failed step of the active job
+     */
+    void Fail();
+    /**
+     * @brief Schedules another attempt, or gives up on the active job
+     */
+    void Retry();
+    /**
+     * @brief Releases the active job and moves on to the next one
+     */
+    void Finish();
+
+    /**
+     * @brief NAND operation completion handler (interrupt context)
+     *
+     * @param result NAND result code
+     * @param pArg Callback user argument
+     */
+    static void StepCallbackFunc(s32 result, void* pArg);
+    /**
+     * @brief Retry alarm handler (interrupt context)
+     *
+     * @param pAlarm OS alarm
+     * @param pCtx Alarm context
+     */
+    static void AlarmCallbackFunc(OSAlarm* pAlarm, OSContext* pCtx);
+
+private:
+    //! Stream used by the active job
+    kiwi::NandStream mStream;
+    //! Alarm for delayed retries
+    OSAlarm mAlarm;
+
+    //! Queued writes
+    Job mJobs[JOB_MAX];
+    //! Job being written
+    Job* volatile mpActive;
+    //! Step of the active job
+    EStep mStep;
+    //! Consecutive failed attempts of the active job
+    int mFailNum;
+    //! Queue order of the next job
+    u32 mNextSequence;
+
+    //! Result of the last NAND operation (set by its callback)
+    volatile s32 mResult;
+    //! Whether a kick is waiting in the message queue
+    volatile bool mIsKickPending;
+
+    //! Wakes the worker
+    OSMessageQueue mMessageQueue;
+    //! Message queue storage
+    OSMessage mMessages[MESSAGE_MAX];
+    //! Write worker
+    kiwi::Thread* mpThread;
+};
+
+} // namespace BAH
+
+#endif
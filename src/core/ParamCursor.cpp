@@ -0,0 +1,84 @@
+#include "core/ParamCursor.h"
+
+#include "core/NandUtil.h"
+
+#include <libkiwi.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param rName NAND file name
+ * @param shard Shard offset
+ * @param shardNum Total number of shards (stride)
+ * @param base First sequence index of the range
+ */
+ParamCursor::ParamCursor(const kiwi::String& rName, u32 shard, u32 shardNum,
+                         u64 base)
+    : mName(rName),
+      mShard(shard),
+      mShardNum(shardNum),
+      mBase(base),
+      mCursor(0) {
+
+    ASSERT(mShardNum > 0);
+    ASSERT(mShard < mShardNum);
+
+    Load();
+}
+
+/**
+ * @brief Advances to the next sequence index
+ *
+ * @return Sequence index
+ */
+u64 ParamCursor::Next() {
+    u64 block = mCursor / BLOCK_SIZE;
+    u64 offset = mCursor % BLOCK_SIZE;
+
+    // Claim the block before using any of it
+    if (offset == 0) {
+        Save(mCursor + BLOCK_SIZE);
+    }
+
+    mCursor++;
+
+    return mBase + (block * mShardNum + mShard) * BLOCK_SIZE + offset;
+}
+
+/**
+ * @brief Loads the resume point (from NAND)
+ */
+void ParamCursor::Load() {
+    kiwi::MemStream strm = kiwi::FileRipper::Open(mName, kiwi::EStorage_NAND);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    mCursor = strm.Read_u64();
+    K_LOG_EX("Resuming %s at %llu\n", mName.CStr(), mCursor);
+}
+
+/**
+ * @brief Saves the resume point (to NAND)
+ *
+ * @param cursor Cursor to resume at
+ */
+void ParamCursor::Save(u64 cursor) const {
+    kiwi::WorkBufferArg arg;
+    arg.size = sizeof(u64);
+    kiwi::WorkBuffer buffer(arg);
+
+    // Write resume point to buffer
+    {
+        kiwi::MemStream strm(buffer);
+        strm.Write_u64(cursor);
+    }
+
+    // Save resume point to the NAND
+    WriteNandFile(mName, buffer);
+}
+
+} // namespace BAH
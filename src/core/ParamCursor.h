@@ -0,0 +1,76 @@
+#ifndef BAH_CLIENT_CORE_PARAM_CURSOR_H
+#define BAH_CLIENT_CORE_PARAM_CURSOR_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Persistent position in a parameter space sequence
+ * @details The sequence is split into blocks that are dealt out to shards in
+ * turn, so clients with different shard offsets never share an index. The
+ * blocks start at a base index, which keeps them apart from other ranges.
+ * Progress is saved once per block, and a restarted client resumes at the
+ * following block, which may skip indices but never repeats them.
+ */
+class ParamCursor {
+public:
+    //! Number of contiguous indices in one block
+    static const u32 BLOCK_SIZE = 4096;
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param rName NAND file name
+     * @param shard Shard offset
+     * @param shardNum Total number of shards (stride)
+     * @param base First sequence index of the range
+     */
+    ParamCursor(const kiwi::String& rName, u32 shard, u32 shardNum,
+                u64 base = 0);
+
+    /**
+     * @brief Advances to the next sequence index
+     *
+     * @return Sequence index
+     */
+    u64 Next();
+
+    /**
+     * @brief Accesses the number of indices taken by this client
+     */
+    u64 GetCursor() const {
+        return mCursor;
+    }
+
+private:
+    /**
+     * @brief Loads the resume point (from NAND)
+     */
+    void Load();
+    /**
+     * @brief Saves the resume point (to NAND)
+     *
+     * @param cursor Cursor to resume at
+     */
+    void Save(u64 cursor) const;
+
+private:
+    //! NAND file name
+    kiwi::String mName;
+
+    //! Shard offset
+    u32 mShard;
+    //! Total number of shards
+    u32 mShardNum;
+    //! First sequence index of the range
+    u64 mBase;
+
+    //! Number of indices taken by this client
+    u64 mCursor;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,75 @@
+#include "core/ParamSpace.h"
+
+#include <libkiwi.h>
+
+namespace BAH {
+
+//! Base of each axis' sequence (first primes)
+const u32 ParamSpace::BASES[AXIS_MAX] = {2, 3, 5, 7, 11, 13, 17, 19};
+
+/**
+ * @brief Constructor
+ */
+ParamSpace::ParamSpace() : mAxisNum(0) {}
+
+/**
+ * @brief Appends an axis to the space
+ *
+ * @param min Lower bound (inclusive)
+ * @param max Upper bound (exclusive)
+ * @return Axis index
+ */
+u32 ParamSpace::AddAxis(f32 min, f32 max) {
+    ASSERT(mAxisNum < AXIS_MAX);
+    ASSERT(min <= max);
+
+    mAxes[mAxisNum].min = min;
+    mAxes[mAxisNum].max = max;
+
+    return mAxisNum++;
+}
+
+/**
+ * @brief Calculates the point at the specified sequence index
+ *
+ * @param index Sequence index
+ * @param[out] pValues Value of each axis
+ */
+void ParamSpace::Sample(u64 index, f32* pValues) const {
+    ASSERT(pValues != nullptr);
+
+    // Index zero is the origin in every base
+    index++;
+
+    for (u32 i = 0; i < mAxisNum; i++) {
+        const Axis& rAxis = mAxes[i];
+
+        f64 t = RadicalInverse(index, BASES[i]);
+        f32 value = static_cast<f32>(rAxis.min + (rAxis.max - rAxis.min) * t);
+
+        // Rounding to f32 can land on the exclusive bound
+        pValues[i] = value < rAxis.max ? value : rAxis.min;
+    }
+}
+
+/**
+ * @brief Reflects the digits of an index about the radix point
+ *
+ * @param index Sequence index
+ * @param base Number base
+ * @return Value in [0, 1)
+ */
+f64 ParamSpace::RadicalInverse(u64 index, u32 base) {
+    f64 inv = 1.0 / base;
+    f64 scale = inv;
+    f64 result = 0.0;
+
+    for (; index > 0; index /= base) {
+        result += (index % base) * scale;
+        scale *= inv;
+    }
+
+    return result;
+}
+
+} // namespace BAH
@@ -0,0 +1,79 @@
+#ifndef BAH_CLIENT_CORE_PARAM_SPACE_H
+#define BAH_CLIENT_CORE_PARAM_SPACE_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Set of bounded parameter axes walked by a Halton sequence
+ * @details Any contiguous run of the sequence covers the space evenly, so
+ * each index maps to one reproducible point.
+ */
+class ParamSpace {
+public:
+    //! Maximum number of axes
+    static const u32 AXIS_MAX = 8;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ParamSpace();
+
+    /**
+     * @brief Appends an axis to the space
+     *
+     * @param min Lower bound (inclusive)
+     * @param max Upper bound (exclusive)
+     * @return Axis index
+     */
+    u32 AddAxis(f32 min, f32 max);
+
+    /**
+     * @brief Accesses the number of axes
+     */
+    u32 GetAxisNum() const {
+        return mAxisNum;
+    }
+
+    /**
+     * @brief Calculates the point at the specified sequence index
+     *
+     * @param index Sequence index
+     * @param[out] pValues Value of each axis
+     */
+    void Sample(u64 index, f32* pValues) const;
+
+private:
+    /**
+     * @brief Parameter axis
+     */
+    struct Axis {
+        f32 min; //!< Lower bound (inclusive)
+        f32 max; //!< Upper bound (exclusive)
+    };
+
+private:
+    /**
+     * @brief Reflects the digits of an index about the radix point
+     *
+     * @param index Sequence index
+     * @param base Number base
+     * @return Value in [0, 1)
+     */
+    static f64 RadicalInverse(u64 index, u32 base);
+
+private:
+    //! Base of each axis' sequence (first primes)
+    static const u32 BASES[AXIS_MAX];
+
+    //! Axis bounds
+    Axis mAxes[AXIS_MAX];
+    //! Number of axes
+    u32 mAxisNum;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,123 @@
+#include "core/ResumeFile.h"
+
+#include "core/NandUtil.h"
+
+#include <libkiwi.h>
+
+#include <cstring>
+
+namespace BAH {
+namespace {
+
+//! NAND file name of each slot
+const char* FILE_NAMES[] = {"resume0.bin", "resume1.bin"};
+
+//! File magic
+const u32 MAGIC = 'RSME';
+
+} // namespace
+
+/**
+ * @brief Constructor
+ */
+ResumeFile::ResumeFile() : mpData(nullptr), mGeneration(0) {
+    mpData = new (32, kiwi::EMemory_MEM2) u8[FILE_SIZE];
+    ASSERT(mpData != nullptr);
+    std::memset(mpData, 0, FILE_SIZE);
+}
+
+/**
+ * @brief Destructor
+ */
+ResumeFile::~ResumeFile() {
+    delete[] mpData;
+    mpData = nullptr;
+}
+
+/**
+ * @brief Loads the newest valid state (from NAND)
+ *
+ * @return Whether any valid state was found
+ */
+bool ResumeFile::Load() {
+    u32 generations[SLOT_NUM];
+    bool valid[SLOT_NUM];
+
+    for (int i = 0; i < SLOT_NUM; i++) {
+        valid[i] = LoadSlot(i, generations[i]);
+    }
+
+    int slot = -1;
+    for (int i = 0; i < SLOT_NUM; i++) {
+        if (valid[i] && (slot < 0 || generations[i] > generations[slot])) {
+            slot = i;
+        }
+    }
+
+    if (slot < 0) {
+        std::memset(mpData, 0, FILE_SIZE);
+        return false;
+    }
+
+    // Buffer holds the last slot read
+    if (slot != SLOT_NUM - 1) {
+        LoadSlot(slot, generations[slot]);
+    }
+
+    mGeneration = generations[slot];
+    K_LOG_EX("Resuming from %s (generation %u)\n", FILE_NAMES[slot],
+             mGeneration);
+
+    return true;
+}
+
+/**
+ * @brief Saves the state over the older file (to NAND)
+ */
+void ResumeFile::Save() {
+    mGeneration++;
+
+    Header* pHeader = reinterpret_cast<Header*>(mpData);
+    pHeader->magic = MAGIC;
+    pHeader->generation = mGeneration;
+    pHeader->checksum = CalcChecksum();
+
+    WriteNandFile(FILE_NAMES[mGeneration % SLOT_NUM], mpData, FILE_SIZE);
+}
+
+/**
+ * @brief Loads one resume file (from NAND)
+ *
+ * @param slot File slot
+ * @param[out] rGeneration File generation
+ * @return Whether the file is valid
+ */
+bool ResumeFile::LoadSlot(int slot, u32& rGeneration) {
+    kiwi::NandStream strm(FILE_NAMES[slot], kiwi::EOpenMode_Read);
+
+    if (!strm.IsOpen() || strm.GetSize() != FILE_SIZE) {
+        return false;
+    }
+
+    strm.Read(mpData, FILE_SIZE);
+
+    const Header* pHeader = reinterpret_cast<const Header*>(mpData);
+    rGeneration = pHeader->generation;
+
+    return pHeader->magic == MAGIC && pHeader->checksum == CalcChecksum();
+}
+
+/**
+ * @brief Calculates the checksum of the current state
+ */
+u32 ResumeFile::CalcChecksum() const {
+    const Header* pHeader = reinterpret_cast<const Header*>(mpData);
+
+    kiwi::Checksum crc;
+    crc.Process(&pHeader->generation, sizeof(u32));
+    crc.Process(GetPayload(), PAYLOAD_SIZE);
+
+    return crc.Result();
+}
+
+} // namespace BAH
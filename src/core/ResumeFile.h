@@ -0,0 +1,95 @@
+#ifndef BAH_CLIENT_CORE_RESUME_FILE_H
+#define BAH_CLIENT_CORE_RESUME_FILE_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Crash-safe storage for the resume state (on NAND)
+ * @details Saves alternate between two files, each stamped with a generation
+ * number and checksum. A save interrupted by a crash can only damage the file
+ * being written, so the other file still holds the previous state.
+ */
+class ResumeFile {
+public:
+    //! Size of the saved state, in bytes
+    static const u32 PAYLOAD_SIZE = 480;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ResumeFile();
+    /**
+     * @brief Destructor
+     */
+    ~ResumeFile();
+
+    /**
+     * @brief Loads the newest valid state (from NAND)
+     *
+     * @return Whether any valid state was found
+     */
+    bool Load();
+    /**
+     * @brief Saves the state over the older file (to NAND)
+     */
+    void Save();
+
+    /**
+     * @brief Accesses the saved state
+     */
+    u8* GetPayload() const {
+        return mpData + HEADER_SIZE;
+    }
+
+    /**
+     * @brief Accesses the generation of the current state
+     */
+    u32 GetGeneration() const {
+        return mGeneration;
+    }
+
+private:
+    /**
+     * @brief Resume file header
+     */
+    struct Header {
+        u32 magic;      //!< File magic
+        u32 generation; //!< Number of saves before this one
+        u32 checksum;   //!< Payload checksum
+    };
+
+    //! Size of the header area, in bytes (keeps the payload aligned)
+    static const u32 HEADER_SIZE = 32;
+    //! Size of one resume file, in bytes
+    static const u32 FILE_SIZE = HEADER_SIZE + PAYLOAD_SIZE;
+    //! Number of resume files
+    static const int SLOT_NUM = 2;
+
+private:
+    /**
+     * @brief Loads one resume file (from NAND)
+     *
+     * @param slot File slot
+     * @param[out] rGeneration File generation
+     * @return Whether the file is valid
+     */
+    bool LoadSlot(int slot, u32& rGeneration);
+
+    /**
+     * @brief Calculates the checksum of the current state
+     */
+    u32 CalcChecksum() const;
+
+private:
+    //! Header followed by the payload
+    u8* mpData;
+    //! Generation of the current state
+    u32 mGeneration;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,60 @@
+#include "core/SeedSchedule.h"
+
+#include <libkiwi.h>
+
+namespace BAH {
+
+/**
+ * @brief Computes the RPUtlRandom seed after a number of steps
+ * @details Runs in O(log steps) by squaring the LCG's affine map.
+ *
+ * @param seed Starting seed
+ * @param steps Number of steps
+ */
+u32 SeedSchedule::Advance(u32 seed, u64 steps) {
+    // Map for 2^i steps (x -> x * mul + inc)
+    u32 mul = LCG_MUL;
+    u32 inc = LCG_INC;
+
+    // Accumulated map for the steps taken so far
+    u32 accMul = 1;
+    u32 accInc = 0;
+
+    // Period is 2^32, so higher bits do not matter
+    for (u32 n = static_cast<u32>(steps); n > 0; n >>= 1) {
+        if (n & 1) {
+            accMul *= mul;
+            accInc = accInc * mul + inc;
+        }
+
+        // Compose the map with itself
+        inc *= mul + 1;
+        mul *= mul;
+    }
+
+    return seed * accMul + accInc;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param base Seed of the first index
+ * @param stride Number of LCG steps between indices
+ * @param shard Shard offset
+ * @param shardNum Total number of shards
+ */
+SeedSchedule::SeedSchedule(u32 base, u32 stride, u32 shard, u32 shardNum)
+    : mCursor("seed.bin", shard, shardNum),
+      mBase(base),
+      mStride(stride),
+      mIndex(0) {}
+
+/**
+ * @brief Advances to the next scheduled seed
+ */
+u32 SeedSchedule::Next() {
+    mIndex = mCursor.Next();
+    return Advance(mBase, mIndex * mStride);
+}
+
+} // namespace BAH
@@ -0,0 +1,71 @@
+#ifndef BAH_CLIENT_CORE_SEED_SCHEDULE_H
+#define BAH_CLIENT_CORE_SEED_SCHEDULE_H
+#include "core/ParamCursor.h"
+
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Places breaks at chosen points of the RPUtlRandom sequence
+ * @details Break N starts at the seed reached after (N * stride) steps from
+ * the base seed. Indices are dealt out by a ParamCursor, so shards cover
+ * disjoint parts of the sequence and restarts do not revisit seeds.
+ */
+class SeedSchedule {
+public:
+    //! Multiplier of the RPUtlRandom LCG
+    static const u32 LCG_MUL = 69069;
+    //! Increment of the RPUtlRandom LCG
+    static const u32 LCG_INC = 1;
+
+public:
+    /**
+     * @brief Computes the RPUtlRandom seed after a number of steps
+     * @details Runs in O(log steps) by squaring the LCG's affine map.
+     *
+     * @param seed Starting seed
+     * @param steps Number of steps
+     */
+    static u32 Advance(u32 seed, u64 steps);
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param base Seed of the first index
+     * @param stride Number of LCG steps between indices
+     * @param shard Shard offset
+     * @param shardNum Total number of shards
+     */
+    SeedSchedule(u32 base, u32 stride, u32 shard, u32 shardNum);
+
+    /**
+     * @brief Advances to the next scheduled seed
+     */
+    u32 Next();
+
+    /**
+     * @brief Accesses the sequence index of the last scheduled seed
+     */
+    u64 GetIndex() const {
+        return mIndex;
+    }
+
+private:
+    //! Position in the schedule
+    ParamCursor mCursor;
+
+    //! Seed of the first index
+    u32 mBase;
+    //! Number of LCG steps between indices
+    u32 mStride;
+
+    //! Sequence index of the last scheduled seed
+    u64 mIndex;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,58 @@
+#include "core/SettleDetector.h"
+
+#include <Pack/RPParty.h>
+
+#include <libkiwi.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param epsilon Speed below which a ball is considered stopped
+ */
+SettleDetector::SettleDetector(f32 epsilon)
+    : mEpsilonSq(epsilon * epsilon), mIsShot(false) {}
+
+/**
+ * @brief Prepares the detector for a new break
+ */
+void SettleDetector::Reset() {
+    mIsShot = false;
+}
+
+/**
+ * @brief Tests whether the table has settled after the shot
+ */
+bool SettleDetector::IsSettled() {
+    bool settled = true;
+
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
+        ASSERT(pBall != nullptr);
+
+        // Ball is about to be pocketed or knocked off
+        if (pBall->GetStateMachine()->IsChangingState()) {
+            settled = false;
+            continue;
+        }
+
+        // Pocketed/off balls are final
+        if (!pBall->IsState(RPBilBall::EState_Wait)) {
+            continue;
+        }
+
+        if (pBall->GetVelocity().squaredLength() > mEpsilonSq) {
+            settled = false;
+
+            // Shot has started once the cue ball moves
+            if (pBall->IsCueBall()) {
+                mIsShot = true;
+            }
+        }
+    }
+
+    return mIsShot && settled;
+}
+
+} // namespace BAH
@@ -0,0 +1,42 @@
+#ifndef BAH_CLIENT_CORE_SETTLE_DETECTOR_H
+#define BAH_CLIENT_CORE_SETTLE_DETECTOR_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Detects when all balls have come to rest after the shot
+ * @details This ends the shot before the game's after-shot states, whose
+ * results only depend on the final ball states.
+ */
+class SettleDetector {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param epsilon Speed below which a ball is considered stopped
+     */
+    explicit SettleDetector(f32 epsilon);
+
+    /**
+     * @brief Prepares the detector for a new break
+     */
+    void Reset();
+
+    /**
+     * @brief Tests whether the table has settled after the shot
+     */
+    bool IsSettled();
+
+private:
+    //! Squared speed below which a ball is considered stopped
+    f32 mEpsilonSq;
+
+    //! Whether the cue ball has been hit yet
+    bool mIsShot;
+};
+
+} // namespace BAH
+
+#endif
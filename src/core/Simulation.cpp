@@ -1,11 +1,18 @@
 #include "core/Simulation.h"
 
 #include "core/BreakInfo.h"
+#include "core/AudioMute.h"
+#include "core/Config.h"
+#include "core/Headless.h"
+#include "core/MotionPruner.h"
 #include "core/RichPresenceProfile.h"
+#include "core/SettleDetector.h"
+#include "core/Unthrottle.h"
 #include <Pack/RPParty.h>
 #include <Pack/RPUtility.h>
 
 #include <libkiwi.h>
+#include <revolution/OS.h>
 
 #include <cmath>
 
@@ -15,72 +22,41 @@ namespace BAH {
 namespace {
 
 /**
- * @brief Counts the number of balls sunk/pocketed
- */
-u32 GetSunkNum() {
-    u32 num = 0;
-
-    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
-        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
-        ASSERT(pBall != nullptr);
-
-        // Ignore cue ball
-        if (pBall->IsCueBall()) {
-            continue;
-        }
-
-        if (pBall->IsState(RPBilBall::EState_Pocket)) {
-            num++;
-        }
-    }
-
-    return num;
-}
-
-/**
- * @brief Counts the number of balls shot off of the table
+ * @brief Measures the time taken to draw random floats
+ *
+ * @param rRandom Random generator
+ * @param num Number of floats
+ * @return Elapsed time, in ticks
  */
-u32 GetOffNum() {
-    u32 num = 0;
-
-    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
-        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
-        ASSERT(pBall != nullptr);
+template <typename TRandom> s32 TimeRandom(TRandom& rRandom, u32 num) {
+    // Keep the results alive so the loop is not optimized away
+    volatile f32 sum = 0.0f;
 
-        // Ignore cue ball
-        if (pBall->IsCueBall()) {
-            continue;
-        }
+    kiwi::Watch watch;
+    watch.Start();
 
-        if (pBall->IsState(RPBilBall::EState_OffTable)) {
-            num++;
-        }
+    for (u32 i = 0; i < num; i++) {
+        sum += rRandom.NextF32();
     }
 
-    return num;
+    return watch.Elapsed();
 }
 
 /**
- * @brief Tests whether the break shot fouled
+ * @brief Compares the throughput of the random generators
  */
-bool GetFoul() {
-    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
-        RPBilBall* pBall = RP_GET_INSTANCE(RPBilBallManager)->GetBall(i);
-        ASSERT(pBall != nullptr);
+void BenchmarkRandom() {
+    static const u32 NUM = 1000000;
 
-        // Cue ball pocketed?
-        if (pBall->IsCueBall() && pBall->IsState(RPBilBall::EState_Pocket)) {
-            ASSERT(i == 0);
-            return true;
-        }
+    kiwi::Random lcg;
+    kiwi::PcgRandom pcg;
 
-        // Any ball shot off the table?
-        if (pBall->IsState(RPBilBall::EState_OffTable)) {
-            return true;
-        }
-    }
+    s32 lcgTime = TimeRandom(lcg, NUM);
+    s32 pcgTime = TimeRandom(pcg, NUM);
 
-    return false;
+    K_LOG_EX("%u floats: LCG %u us, PCG32 %u us\n", NUM,
+             static_cast<u32>(OS_TICKS_TO_USEC(lcgTime)),
+             static_cast<u32>(OS_TICKS_TO_USEC(pcgTime)));
 }
 
 } // namespace
@@ -109,18 +85,75 @@ Simulation::Simulation()
       mHttpError(kiwi::EHttpErr_Success),
       mHttpExError(0),
       mHttpStatus(kiwi::EHttpStatus_None),
+      mpUploadQueue(nullptr),
       mTimerUp(0),
       mTimerLeft(0),
       mTimerRight(0),
       mpCurrBreak(nullptr),
       mpBestBreak(nullptr),
+      mpReplayBreak(nullptr),
+      mpReplayQueue(nullptr),
+      mReplayQueueNum(0),
+      mpSnapshot(nullptr),
+      mIsRealReset(false),
+      mpSnapshotBreak(nullptr),
+      mIsSnapshotBreakValid(false),
+      mIsSnapshotCheck(false),
+      mSnapshotCheckNum(0),
+      mIsSnapshotFailed(false),
+      mpCheckpoint(nullptr),
+      mCheckpointSeed(0),
+      mCheckpointFrame(0),
+      mVariantNum(0),
+      mpForkBreak(nullptr),
+      mIsForkBreakValid(false),
+      mIsForkCheck(false),
+      mForkCheckNum(0),
+      mIsForkFailed(false),
+      mStyle(EStyle_Normal),
+      mIsLeased(false),
+      mpLocalSearch(nullptr),
+      mIsLocal(false),
+      mpBandit(nullptr),
+      mArm(0),
+      mpExplored(nullptr),
+      mpSeedSchedule(nullptr),
+      mpLeaderboard(nullptr),
+      mpJournal(nullptr),
+      mpResume(nullptr),
+      mResumeTime(OSGetTime()),
+      mPcgPosition(0),
+      mpPruner(nullptr),
+      mIsPruned(false),
+      mPruneBound(0),
+      mpCensus(nullptr),
+      mpSettle(nullptr),
+      mIsSettled(false),
+      mIsSettleFinish(false),
+      mSettleSunk(0),
+      mSettleOff(0),
+      mSettleFoul(false),
       mIsFirstRun(true),
       mIsFirstTick(false),
       mIsReplay(false),
       mIsFinished(false),
-      mBreakNum(0) {
+      mIsAborted(false),
+      mBreakNum(0),
+      mPruneNum(0),
+      mAbortNum(0),
+      mLocalNum(0),
+      mMismatchNum(0),
+      mSnapshotMismatchNum(0),
+      mSettleMismatchNum(0),
+      mPruneMismatchNum(0),
+      mSettleNum(0) {
 
     std::memset(mBreakBallNum, 0, sizeof(mBreakBallNum));
+    std::memset(mpParamCursors, 0, sizeof(mpParamCursors));
+    std::memset(mpLeaseClients, 0, sizeof(mpLeaseClients));
+
+    // Index ranges and random streams are per user
+    LoadUser();
 
     mpCurrBreak = new (32, kiwi::EMemory_MEM2) BreakInfo();
     ASSERT(mpCurrBreak != nullptr);
@@ -128,12 +161,159 @@ Simulation::Simulation()
     mpBestBreak = new (32, kiwi::EMemory_MEM2) BreakInfo();
     ASSERT(mpBestBreak != nullptr);
 
+    mpReplayBreak = new (32, kiwi::EMemory_MEM2) BreakInfo();
+    ASSERT(mpReplayBreak != nullptr);
+
+    mpReplayQueue =
+        new (32, kiwi::EMemory_MEM2) BreakInfo[REPLAY_QUEUE_MAX];
+    ASSERT(mpReplayQueue != nullptr);
+
+    mpForkBreak = new (32, kiwi::EMemory_MEM2) BreakInfo();
+    ASSERT(mpForkBreak != nullptr);
+
+    mpSnapshot = new (32, kiwi::EMemory_MEM2) TableSnapshot();
+    ASSERT(mpSnapshot != nullptr);
+
+    mpSnapshotBreak = new (32, kiwi::EMemory_MEM2) BreakInfo();
+    ASSERT(mpSnapshotBreak != nullptr);
+
+    mpCheckpoint = new (32, kiwi::EMemory_MEM2) TableSnapshot();
+    ASSERT(mpCheckpoint != nullptr);
+
+    mpCensus = new (32, kiwi::EMemory_MEM2) BallCensus();
+    ASSERT(mpCensus != nullptr);
+
+    if (Config::GetInstance().IsPrune()) {
+        mpPruner = new (32, kiwi::EMemory_MEM2)
+            MotionPruner(Config::GetInstance().GetPruneEpsilon(),
+                         Config::GetInstance().GetPruneChain());
+        ASSERT(mpPruner != nullptr);
+    }
+
+    if (Config::GetInstance().IsSettle()) {
+        mpSettle = new (32, kiwi::EMemory_MEM2)
+            SettleDetector(Config::GetInstance().GetSettleEpsilon());
+        ASSERT(mpSettle != nullptr);
+    }
+
+    if (Config::GetInstance().IsEnumerate()) {
+        f32 powerMin = kiwi::Min(Config::GetInstance().GetForkPowerMin(),
+                                 POWER_MAX);
+
+        // Leases are dealt out from index zero, so fall back elsewhere
+        u64 base = Config::GetInstance().IsLease()
+                       ? LeaseClient::GetFallbackBase(GetRandomStream())
+                       : 0;
+
+        for (int i = 0; i < EStyle_Max; i++) {
+            mpParamCursors[i] = new (32, kiwi::EMemory_MEM2)
+                ParamCursor(kiwi::Format("cursor%d.bin", i),
+                            Config::GetInstance().GetShard(),
+                            Config::GetInstance().GetShardNum(), base);
+            ASSERT(mpParamCursors[i] != nullptr);
+
+            if (Config::GetInstance().IsLease()) {
+                mpLeaseClients[i] = new (32, kiwi::EMemory_MEM2) LeaseClient(i);
+                ASSERT(mpLeaseClients[i] != nullptr);
+            }
+        }
+
+        // Same ranges as the random styles (see AfterReset)
+        ParamSpace& rNormal = mParamSpaces[EStyle_Normal];
+        rNormal.AddAxis(-35.0f, 35.0f);
+        rNormal.AddAxis(-12.0f, 12.0f);
+        rNormal.AddAxis(-0.015f, 0.015f);
+        rNormal.AddAxis(0.15f, 0.30f);
+        rNormal.AddAxis(powerMin, POWER_MAX);
+
+        // Frames are truncated, so the bound is one past the last frame
+        ParamSpace& rJump = mParamSpaces[EStyle_Jump];
+        rJump.AddAxis(40.0f, 56.0f);
+        rJump.AddAxis(-8.0f, 8.0f);
+        rJump.AddAxis(-0.015f, 0.015f);
+        rJump.AddAxis(0.15f, 0.35f);
+        rJump.AddAxis(powerMin, POWER_MAX);
+    }
+
+    if (Config::GetInstance().IsRandomBench()) {
+        BenchmarkRandom();
+    }
+
+    if (Config::GetInstance().IsExplored()) {
+        mpExplored = new (32, kiwi::EMemory_MEM2)
+            ExploredIndex(Config::GetInstance().GetExploredKB() * 1024);
+        ASSERT(mpExplored != nullptr);
+    }
+
+    if (Config::GetInstance().IsSeedSchedule()) {
+        mpSeedSchedule = new (32, kiwi::EMemory_MEM2)
+            SeedSchedule(Config::GetInstance().GetSeedBase(),
+                         Config::GetInstance().GetSeedStride(),
+                         Config::GetInstance().GetShard(),
+                         Config::GetInstance().GetShardNum());
+        ASSERT(mpSeedSchedule != nullptr);
+    }
+
+    if (Config::GetInstance().IsLeaderboard()) {
+        mpLeaderboard = new (32, kiwi::EMemory_MEM2)
+            Leaderboard(Config::GetInstance().GetLeaderboardNum());
+        ASSERT(mpLeaderboard != nullptr);
+    }
+
+    if (Config::GetInstance().IsJournal()) {
+        mpJournal = new (32, kiwi::EMemory_MEM2)
+            BreakJournal(Config::GetInstance().GetJournalBatch());
+        ASSERT(mpJournal != nullptr);
+    }
+
+    if (Config::GetInstance().IsResume()) {
+        mpResume = new (32, kiwi::EMemory_MEM2) ResumeFile();
+        ASSERT(mpResume != nullptr);
+    }
+
+    if (Config::GetInstance().IsUploadQueue()) {
+        mpUploadQueue = new (32, kiwi::EMemory_MEM2)
+            UploadQueue(Config::GetInstance().GetUploadQueueNum());
+        ASSERT(mpUploadQueue != nullptr);
+    }
+
+    if (Config::GetInstance().IsBandit()) {
+        mpBandit = new (32, kiwi::EMemory_MEM2)
+            StyleBandit(EStyle_Max * ESide_Max, UPLOAD_BALL_MIN,
+                        Config::GetInstance().GetBanditFloor());
+        ASSERT(mpBandit != nullptr);
+    }
+
+    if (Config::GetInstance().GetLocalSearch() > 0.0f) {
+        mpLocalSearch = new (32, kiwi::EMemory_MEM2) LocalSearch(
+            Config::GetInstance().GetLocalSearch(),
+            kiwi::Min(Config::GetInstance().GetForkPowerMin(), POWER_MAX),
+            POWER_MAX);
+        ASSERT(mpLocalSearch != nullptr);
+    }
+
     // Load previous session information
-    LoadUser();
     LoadBreak();
 
-    // Default to max power
-    mpCurrBreak->power = POWER_MAX;
+    // Bests are only journaled when the journal is used
+    if (mpJournal != nullptr && mpJournal->HasBest() &&
+        mpJournal->GetBest().IsBetterThan(*mpBestBreak)) {
+        *mpBestBreak = mpJournal->GetBest();
+    }
+
+    // Pick up where the last session left off
+    if (mpLocalSearch != nullptr &&
+        mpBestBreak->sunk + mpBestBreak->off >=
+            Config::GetInstance().GetLocalSearchMin()) {
+        mpLocalSearch->SetCenter(*mpBestBreak);
+    }
+
+    // Each user draws from their own stream, from a new start each session
+    mPcgRandom.SetSeed(OSGetTick(), GetRandomStream());
+
+    if (mpResume != nullptr) {
+        LoadResume();
+    }
 }
 
 /**
@@ -145,6 +325,65 @@ Simulation::~Simulation() {
 
     delete mpBestBreak;
     mpBestBreak = nullptr;
+
+    delete mpReplayBreak;
+    mpReplayBreak = nullptr;
+
+    delete[] mpReplayQueue;
+    mpReplayQueue = nullptr;
+
+    delete mpForkBreak;
+    mpForkBreak = nullptr;
+
+    delete mpSnapshot;
+    mpSnapshot = nullptr;
+
+    delete mpSnapshotBreak;
+    mpSnapshotBreak = nullptr;
+
+    delete mpCheckpoint;
+    mpCheckpoint = nullptr;
+
+    delete mpPruner;
+    mpPruner = nullptr;
+
+    delete mpCensus;
+    mpCensus = nullptr;
+
+    delete mpSettle;
+    mpSettle = nullptr;
+
+    delete mpLocalSearch;
+    mpLocalSearch = nullptr;
+
+    delete mpBandit;
+    mpBandit = nullptr;
+
+    delete mpExplored;
+    mpExplored = nullptr;
+
+    delete mpSeedSchedule;
+    mpSeedSchedule = nullptr;
+
+    delete mpLeaderboard;
+    mpLeaderboard = nullptr;
+
+    delete mpJournal;
+    mpJournal = nullptr;
+
+    delete mpResume;
+    mpResume = nullptr;
+
+    delete mpUploadQueue;
+    mpUploadQueue = nullptr;
+
+    for (int i = 0; i < EStyle_Max; i++) {
+        delete mpParamCursors[i];
+        mpParamCursors[i] = nullptr;
+
+        delete mpLeaseClients[i];
+        mpLeaseClients[i] = nullptr;
+    }
 }
 
 /**
@@ -158,11 +397,42 @@ void Simulation::Configure(RPSysScene* pScene) {
     // Add to renderer for debug display
     RPGrpRenderer::GetCurrent()->AppendDrawObject(this);
 
+    // Unattended instances have no use for audio
+    if (!Config::GetInstance().IsAudio()) {
+        AudioMute::GetInstance().Stop();
+    }
+
     // Start up Discord rich presence
     // kiwi::RichPresenceMgr::GetInstance().SetProfile(new
     // RichPresenceProfile());
 }
 
+/**
+ * @brief Exit callback
+ *
+ * @param pScene Current scene
+ */
+void Simulation::Exit(RPSysScene* pScene) {
+#pragma unused(pScene)
+
+    // Patches must not outlive the scene
+    Headless::GetInstance().Exit();
+    Unthrottle::GetInstance().Set(false);
+
+    // Keep what the last interval learned
+    if (mpBandit != nullptr) {
+        mpBandit->Flush();
+    }
+
+    if (mpExplored != nullptr) {
+        mpExplored->Flush();
+    }
+
+    if (mpLeaderboard != nullptr) {
+        mpLeaderboard->Flush();
+    }
+}
+
 /**
  * @brief Standard draw pass
  */
@@ -200,6 +470,70 @@ void Simulation::UserDraw() {
         .SetStrokeType(kiwi::ETextStroke_Outline)
         .SetDrawFlags(kiwi::ETextFlag_TextCenter);
 
+    /**
+     * Style statistics
+     */
+    if (mpBandit != nullptr) {
+        static const char* STYLE_NAMES[EStyle_Max] = {"normal", "jump"};
+        static const char* SIDE_NAMES[ESide_Max] = {"left", "right"};
+
+        kiwi::Text("[Styles]")
+            .SetPosition(0.70f, 0.40f)
+            .SetTextColor(kiwi::Color::CYAN)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+
+        kiwi::String stats;
+        for (u32 i = 0; i < mpBandit->GetArmNum(); i++) {
+            stats += kiwi::Format("> %s/%s: %d of %d\n",
+                                  STYLE_NAMES[i / ESide_Max],
+                                  SIDE_NAMES[i % ESide_Max],
+                                  mpBandit->GetYieldNum(i),
+                                  mpBandit->GetBreakNum(i));
+        }
+
+        kiwi::Text("%s", stats.CStr())
+            .SetPosition(0.70f, 0.45f)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+
+    /**
+     * Leaderboard
+     */
+    if (mpLeaderboard != nullptr) {
+        kiwi::Text("[Leaderboard]")
+            .SetPosition(0.20f, 0.10f)
+            .SetTextColor(kiwi::Color::CYAN)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+
+        const BreakInfo* pTop[LEADERBOARD_DRAW_NUM];
+        u32 topNum = mpLeaderboard->GetTop(pTop, LEADERBOARD_DRAW_NUM);
+
+        kiwi::String board;
+        for (u32 i = 0; i < topNum; i++) {
+            board += kiwi::Format("> #%d: %d balls (%d sunk) in %03df%s\n",
+                                  i + 1, pTop[i]->sunk + pTop[i]->off,
+                                  pTop[i]->sunk, pTop[i]->frame,
+                                  pTop[i]->foul ? ", foul" : "");
+        }
+
+        board += "> exemplars:";
+        for (int i = Leaderboard::EXEMPLAR_NUM - 1; i >= 0; i--) {
+            const BreakInfo* pExemplar = mpLeaderboard->GetExemplar(i);
+
+            if (pExemplar != nullptr) {
+                board += kiwi::Format(" %d:%df", i, pExemplar->frame);
+            }
+        }
+
+        kiwi::Text("%s", board.CStr())
+            .SetPosition(0.20f, 0.15f)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+
     /**
      * Session statistics
      */
@@ -210,11 +544,18 @@ void Simulation::UserDraw() {
         .SetDrawFlags(kiwi::ETextFlag_TextCenter);
 
     kiwi::Text("> %d total breaks\n"
+               "> %d pruned, %d aborted, %d settled breaks\n"
+               "> %d replay, %d snapshot, %d settle, %d prune mismatches\n"
                "> distribution:\n"
                "{%d, %d, %d, %d, %d}\n"
                "{%d, %d, %d, %d, %d}\n",
                // > %d total breaks
                mBreakNum,
+               // > %d pruned, %d aborted, %d settled breaks
+               mPruneNum, mAbortNum, mSettleNum,
+               // > %d replay, %d snapshot, %d settle, %d prune mismatches
+               mMismatchNum, mSnapshotMismatchNum, mSettleMismatchNum,
+               mPruneMismatchNum,
                // > distribution:
                // {%d, %d, %d, %d, %d}
                mBreakBallNum[0], mBreakBallNum[1], mBreakBallNum[2],
@@ -226,9 +567,29 @@ void Simulation::UserDraw() {
         .SetStrokeType(kiwi::ETextStroke_Outline)
         .SetDrawFlags(kiwi::ETextFlag_TextCenter);
 
+    /**
+     * Deferred replays
+     */
+    if (mReplayQueueNum > 0 && !mIsReplay) {
+        kiwi::Text("[A] Watch replay (%d queued)", mReplayQueueNum)
+            .SetPosition(0.70f, 0.90f)
+            .SetTextColor(kiwi::Color::GREEN)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+
     /**
      * Network information
      */
+    // Status is picked up from the upload worker in Finish
+    if (mpUploadQueue != nullptr) {
+        kiwi::Text("Uploads: %d queued, %d dropped",
+                   mpUploadQueue->GetDepth(), mpUploadQueue->GetDropNum())
+            .SetPosition(0.20f, 0.75f)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+
     if (mIsConnected.HasValue()) {
         kiwi::Text(*mIsConnected ? "Online" : "Offline (err:%d ex:%d stat:%d) ",
                    mHttpError, mHttpExError, mHttpStatus)
@@ -244,6 +605,57 @@ void Simulation::UserDraw() {
         .SetTextColor(kiwi::Color::RED)
         .SetStrokeType(kiwi::ETextStroke_Outline)
         .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+
+    /**
+     * Local search
+     */
+    if (mpLocalSearch != nullptr) {
+        kiwi::Text("[1] Local search %s (%d breaks)",
+                   mpLocalSearch->IsEnabled() ? "on" : "off", mLocalNum)
+            .SetPosition(0.20f, 0.90f)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+
+    /**
+     * Explored index
+     */
+    if (mpExplored != nullptr) {
+        kiwi::Text("Explored: %d of %d redrawn (fp %.2f%%)",
+                   mpExplored->GetHitNum(), mpExplored->GetTestNum(),
+                   mpExplored->CalcFalsePositiveRate() * 100.0f)
+            .SetPosition(0.20f, 0.95f)
+            .SetStrokeType(kiwi::ETextStroke_Outline)
+            .SetDrawFlags(kiwi::ETextFlag_TextCenter);
+    }
+}
+
+/**
+ * @brief Logs a one-line session summary to the console
+ */
+void Simulation::LogStatus() const {
+    ASSERT(mpBestBreak != nullptr);
+
+    K_LOG_EX("%d breaks (%d pruned, %d aborted), best %d balls in %d "
+             "frames\n",
+             mBreakNum, mPruneNum, mAbortNum,
+             mpBestBreak->sunk + mpBestBreak->off, mpBestBreak->frame);
+
+    K_LOG_EX("Main loop: %.1f frames/sec%s\n",
+             Unthrottle::GetInstance().GetFrameRate(),
+             Unthrottle::GetInstance().IsEnabled() ? " (unthrottled)" : "");
+
+    if (mpExplored != nullptr) {
+        K_LOG_EX("Explored: %d of %d redrawn (fp %.4f)\n",
+                 mpExplored->GetHitNum(), mpExplored->GetTestNum(),
+                 mpExplored->CalcFalsePositiveRate());
+    }
+
+    if (mpUploadQueue != nullptr) {
+        K_LOG_EX("Uploads: %d queued, %d of %d dropped\n",
+                 mpUploadQueue->GetDepth(), mpUploadQueue->GetDropNum(),
+                 mpUploadQueue->GetPushNum() + mpUploadQueue->GetDropNum());
+    }
 }
 
 /**
@@ -296,6 +708,163 @@ void Simulation::LoadBreak() {
     mpBestBreak->frame = ULONG_MAX;
 }
 
+/**
+ * @brief Restores search progress from the last checkpoint (from NAND)
+ */
+void Simulation::LoadResume() {
+    ASSERT(mpResume != nullptr);
+
+    if (!mpResume->Load()) {
+        return;
+    }
+
+    kiwi::MemStream strm(mpResume->GetPayload(), ResumeFile::PAYLOAD_SIZE);
+
+    // Layout changed since the checkpoint
+    if (strm.Read_u32() != RESUME_VERSION) {
+        K_LOG("Discarding old resume checkpoint\n");
+        return;
+    }
+
+    mBreakNum = strm.Read_u32();
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        mBreakBallNum[i] = strm.Read_u32();
+    }
+
+    mPruneNum = strm.Read_u32();
+    mAbortNum = strm.Read_u32();
+    mLocalNum = strm.Read_u32();
+    mMismatchNum = strm.Read_u32();
+    mSnapshotMismatchNum = strm.Read_u32();
+    mSettleMismatchNum = strm.Read_u32();
+    mPruneMismatchNum = strm.Read_u32();
+    mSettleNum = strm.Read_u32();
+
+    // Continue the random stream where it was left
+    bool pcg = strm.Read_bool();
+    if (pcg) {
+        u32 seed = strm.Read_u32();
+        u64 position = strm.Read_u64();
+
+        if (Config::GetInstance().IsPcgRandom()) {
+            mPcgRandom.SetSeed(seed, GetRandomStream());
+            mPcgPosition = position;
+        }
+    }
+
+    bool local = strm.Read_bool();
+    if (local && mpLocalSearch != nullptr) {
+        mpLocalSearch->Read(strm);
+    }
+
+    // Finish the leases that were in progress
+    for (int i = 0; i < EStyle_Max; i++) {
+        bool lease = strm.Read_bool();
+
+        if (lease && mpLeaseClients[i] != nullptr) {
+            mpLeaseClients[i]->Read(strm);
+        }
+    }
+}
+
+/**
+ * @brief Checkpoints search progress (to NAND)
+ */
+void Simulation::SaveResume() {
+    ASSERT(mpResume != nullptr);
+
+    kiwi::MemStream strm(mpResume->GetPayload(), ResumeFile::PAYLOAD_SIZE);
+    strm.Write_u32(RESUME_VERSION);
+
+    strm.Write_u32(mBreakNum);
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        strm.Write_u32(mBreakBallNum[i]);
+    }
+
+    strm.Write_u32(mPruneNum);
+    strm.Write_u32(mAbortNum);
+    strm.Write_u32(mLocalNum);
+    strm.Write_u32(mMismatchNum);
+    strm.Write_u32(mSnapshotMismatchNum);
+    strm.Write_u32(mSettleMismatchNum);
+    strm.Write_u32(mPruneMismatchNum);
+    strm.Write_u32(mSettleNum);
+
+    // Breaks are addressed by their position from the seed
+    bool pcg = Config::GetInstance().IsPcgRandom();
+    strm.Write_bool(pcg);
+    if (pcg) {
+        strm.Write_u32(mPcgRandom.GetSeed());
+        strm.Write_u64(mPcgPosition);
+    }
+
+    strm.Write_bool(mpLocalSearch != nullptr);
+    if (mpLocalSearch != nullptr) {
+        mpLocalSearch->Write(strm);
+    }
+
+    for (int i = 0; i < EStyle_Max; i++) {
+        strm.Write_bool(mpLeaseClients[i] != nullptr);
+
+        if (mpLeaseClients[i] != nullptr) {
+            mpLeaseClients[i]->Write(strm);
+        }
+    }
+
+    mpResume->Save();
+}
+
+/**
+ * @brief Resets the table for the next break
+ */
+void Simulation::ResetTable() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpSnapshot != nullptr);
+
+    // Aborted breaks may be stuck in state the snapshot does not cover
+    bool force = mIsAborted;
+    mIsAborted = false;
+
+    // Replays always use the real reset
+    bool snapshot = Config::GetInstance().IsTableSnapshot() && !mIsReplay &&
+                    !force && !mIsSnapshotFailed && mpSnapshot->IsValid();
+
+    // Restoring must reproduce whole breaks before it replaces real resets
+    bool check = Config::GetInstance().IsTableSnapshotVerify() ||
+                 mSnapshotCheckNum < SNAPSHOT_CHECK_MIN;
+
+    // Checks alternate with the real resets that provide their breaks
+    mIsSnapshotCheck = snapshot && check && mIsSnapshotBreakValid;
+    mIsRealReset = !snapshot || (check && !mIsSnapshotCheck);
+
+    if (mIsSnapshotCheck) {
+        mIsSnapshotBreakValid = false;
+    }
+
+    BeforeReset();
+
+    if (mIsRealReset) {
+        u32 seed = RPUtlRandom::getSeed();
+        RP_GET_INSTANCE(RPBilMain)->Reset();
+
+        // Capture after the first real reset
+        if (Config::GetInstance().IsTableSnapshot() && !mIsSnapshotFailed &&
+            !mpSnapshot->IsValid()) {
+            // One snapshot cannot stand in for layouts drawn from the seed
+            if (RPUtlRandom::getSeed() != seed) {
+                K_LOG("Snapshot disabled (reset layout depends on the seed)\n");
+                mIsSnapshotFailed = true;
+            } else {
+                mpSnapshot->Capture();
+            }
+        }
+    } else {
+        mpSnapshot->Restore();
+    }
+
+    AfterReset();
+}
+
 /**
  * @brief Logic before scene reset
  */
@@ -306,10 +875,34 @@ void Simulation::BeforeReset() {
     mIsFinished = false;
     mIsFirstTick = true;
 
+    // Variants are only valid for the same aiming
+    mpCheckpoint->Invalidate();
+    mVariantNum = 0;
+    mIsForkBreakValid = false;
+    mIsForkCheck = false;
+
+    StartBreak();
+
+    mIsLocal = false;
+
     if (mIsReplay) {
         // Restore seed for replay
-        RPUtlRandom::setSeed(mpBestBreak->seed);
+        RPUtlRandom::setSeed(mpReplayBreak->seed);
+    } else if (mIsSnapshotCheck) {
+        // Same random state as the snapshot break
+        RPUtlRandom::setSeed(mpSnapshotBreak->seed);
+        mpCurrBreak->seed = mpSnapshotBreak->seed;
     } else {
+        // Local search may take over this break
+        mIsLocal = mpLocalSearch != nullptr && mpLocalSearch->Roll();
+
+        // Keep the table layout of the break being searched around
+        if (mIsLocal && Config::GetInstance().IsLocalSearchSeed()) {
+            RPUtlRandom::setSeed(mpLocalSearch->GetCenter().seed);
+        } else if (mpSeedSchedule != nullptr) {
+            RPUtlRandom::setSeed(mpSeedSchedule->Next());
+        }
+
         // Record starting seed
         mpCurrBreak->seed = RPUtlRandom::getSeed();
     }
@@ -324,86 +917,382 @@ void Simulation::AfterReset() {
 
     // Replay ignores further randomization
     if (mIsReplay) {
-        mTimerUp = mpBestBreak->up;
-        mTimerLeft = mpBestBreak->left;
-        mTimerRight = mpBestBreak->right;
+        // Frame count is re-measured for verification
+        mpCurrBreak->frame = 0;
+
+        mTimerUp = mpReplayBreak->up;
+        mTimerLeft = mpReplayBreak->left;
+        mTimerRight = mpReplayBreak->right;
         return;
     }
 
-    // Seeded by OS clock
-    kiwi::Random random;
-    mpCurrBreak->kseed = random.GetSeed();
+    // Snapshot checks re-run the snapshot break
+    if (mIsSnapshotCheck) {
+        *mpCurrBreak = *mpSnapshotBreak;
+        mpCurrBreak->frame = 0;
+        mIsLeased = false;
+
+        mTimerUp = mpCurrBreak->up;
+        mTimerLeft = mpCurrBreak->left;
+        mTimerRight = mpCurrBreak->right;
+        return;
+    }
 
     mpCurrBreak->frame = 0;
     mTimerUp = mpCurrBreak->up = 0;
     mTimerLeft = mpCurrBreak->left = 0;
     mTimerRight = mpCurrBreak->right = 0;
 
-    // Pick a random style
-    EStyle style = static_cast<EStyle>(random.NextU32(EStyle_Max));
+    // Each path records where its aiming and hit came from
+    mpCurrBreak->source = BreakInfo::ESource_None;
+    mpCurrBreak->stream = 0;
+    mpCurrBreak->index = 0;
 
-    switch (style) {
-    case EStyle_Normal: {
-        // 50% chance to aim up
-        if (random.CoinFlip()) {
-            // Randomize aiming UP frames -> [0f, 35f]
-            mTimerUp = mpCurrBreak->up = random.NextU32(35);
-        }
+    // Perturb the best break instead of exploring
+    if (mIsLocal) {
+        mpLocalSearch->Propose(*mpCurrBreak);
+        mpCurrBreak->source = BreakInfo::ESource_Local;
+        mIsLeased = false;
 
-        // 80% chance to aim sideways
-        if (random.Chance(0.8f)) {
-            // 50% chance to aim left vs. aim right
-            if (random.CoinFlip()) {
-                // Randomize aiming SIDEWAYS frames -> [0f, 12f]
-                mTimerLeft = mpCurrBreak->left = random.NextU32(12);
-            } else {
-                // Randomize aiming SIDEWAYS frames -> [0f, 12f]
-                mTimerRight = mpCurrBreak->right = random.NextU32(12);
-            }
-        }
+        mStyle = mpCurrBreak->up >= 40 ? EStyle_Jump : EStyle_Normal;
+        mpCurrBreak->style = mStyle;
 
-        // Base cue position
-        mpCurrBreak->pos = EGG::Vector2f(0.015f, 0.15f);
+        // Variants of this break are explored results (see NextVariant)
+        mArm = mStyle * ESide_Max +
+               (mpCurrBreak->left > 0 ? ESide_Left : ESide_Right);
 
-        // Randomize X pos -> [-0.015, +0.015]
-        mpCurrBreak->pos.x *= random.NextF32();
-        // 50% chance to flip
-        mpCurrBreak->pos.x *= random.Sign();
+        mTimerUp = mpCurrBreak->up;
+        mTimerLeft = mpCurrBreak->left;
+        mTimerRight = mpCurrBreak->right;
+        return;
+    }
 
-        // Randomize Y pos -> [+0.15, +0.30]
-        mpCurrBreak->pos.y += random.NextF32(0.15f);
-        break;
+    // Walk the parameter space instead of sampling it
+    if (Config::GetInstance().IsEnumerate()) {
+        EnumerateParams();
+        return;
     }
 
-    case EStyle_Jump: {
-        // Randomize aiming UP frames -> [40f, 55f]
-        mTimerUp = mpCurrBreak->up = random.NextU32(40, 55);
+    if (Config::GetInstance().IsPcgRandom()) {
+        DrawBreak(mPcgRandom);
+    } else {
+        // Seeded by OS clock
+        kiwi::Random random;
+        DrawBreak(random);
+    }
+}
 
-        // 50% chance to aim sideways
-        if (random.CoinFlip()) {
-            // 50% chance to aim left vs. aim right
-            if (random.CoinFlip()) {
-                // Randomize aiming SIDEWAYS frames -> [0f, 8f]
-                mTimerLeft = mpCurrBreak->left = random.NextU32(8);
+/**
+ * @brief Draws a random break, skipping explored configurations
+ *
+ * @param rRandom Random generator
+ */
+template <typename TRandom> void Simulation::DrawBreak(TRandom& rRandom) {
+    for (u32 i = 0; i <= REDRAW_MAX; i++) {
+        RandomizeBreak(rRandom);
+
+        // Redraw configurations that were already simulated
+        if (mpExplored == nullptr || !mpExplored->TestAndInsert(*mpCurrBreak)) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Records the generator state that reproduces the upcoming draws
+ *
+ * @param rRandom Random generator
+ */
+void Simulation::TakeSeed(kiwi::Random& rRandom) {
+    ASSERT(mpCurrBreak != nullptr);
+
+    // LCG state is its own seed
+    mpCurrBreak->source = BreakInfo::ESource_Random;
+    mpCurrBreak->kseed = rRandom.GetSeed();
+}
+
+/**
+ * @brief Moves the generator to the next break and records its position
+ * @details Each break starts its draws at its own position in the stream,
+ * so no two breaks of a session share outputs, and the seed, stream, and
+ * position reproduce any of them.
+ *
+ * @param rRandom Random generator
+ */
+void Simulation::TakeSeed(kiwi::PcgRandom& rRandom) {
+    ASSERT(mpCurrBreak != nullptr);
+
+    rRandom.SetSeed(rRandom.GetSeed(), rRandom.GetStream());
+    rRandom.Advance(mPcgPosition);
+
+    mpCurrBreak->source = BreakInfo::ESource_Pcg;
+    mpCurrBreak->kseed = rRandom.GetSeed();
+    mpCurrBreak->stream = rRandom.GetStream();
+    mpCurrBreak->index = mPcgPosition;
+
+    mPcgPosition += PCG_BREAK_STRIDE;
+}
+
+/**
+ * @brief Randomizes the style, aiming, and hit
+ *
+ * @param rRandom Random generator
+ */
+template <typename TRandom>
+void Simulation::RandomizeBreak(TRandom& rRandom) {
+    ASSERT(mpCurrBreak != nullptr);
+
+    TakeSeed(rRandom);
+
+    mTimerUp = mpCurrBreak->up = 0;
+    mTimerLeft = mpCurrBreak->left = 0;
+    mTimerRight = mpCurrBreak->right = 0;
+
+    // Bandit picks the style and the sideways direction
+    kiwi::Optional<ESide> side;
+
+    if (mpBandit != nullptr) {
+        mArm = mpBandit->Choose();
+        mStyle = static_cast<EStyle>(mArm / ESide_Max);
+        side = static_cast<ESide>(mArm % ESide_Max);
+    } else {
+        // Pick a random style
+        mStyle = static_cast<EStyle>(rRandom.NextU32(EStyle_Max));
+    }
+
+    switch (mStyle) {
+    case EStyle_Normal: {
+        // 50% chance to aim up
+        if (rRandom.CoinFlip()) {
+            // Randomize aiming UP frames -> [0f, 35f]
+            mTimerUp = mpCurrBreak->up = rRandom.NextU32(35);
+        }
+
+        // 80% chance to aim sideways
+        if (rRandom.Chance(0.8f)) {
+            // 50% chance to aim left vs. aim right
+            if (side.HasValue() ? *side == ESide_Left : rRandom.CoinFlip()) {
+                // Randomize aiming SIDEWAYS frames -> [0f, 12f]
+                mTimerLeft = mpCurrBreak->left = rRandom.NextU32(12);
+            } else {
+                // Randomize aiming SIDEWAYS frames -> [0f, 12f]
+                mTimerRight = mpCurrBreak->right = rRandom.NextU32(12);
+            }
+        }
+
+        break;
+    }
+
+    case EStyle_Jump: {
+        // Randomize aiming UP frames -> [40f, 55f]
+        // (generators disagree on whether NextU32(min, max) includes max)
+        mTimerUp = mpCurrBreak->up = 40 + rRandom.NextU32(16);
+
+        // 50% chance to aim sideways
+        if (rRandom.CoinFlip()) {
+            // 50% chance to aim left vs. aim right
+            if (side.HasValue() ? *side == ESide_Left : rRandom.CoinFlip()) {
+                // Randomize aiming SIDEWAYS frames -> [0f, 8f]
+                mTimerLeft = mpCurrBreak->left = rRandom.NextU32(8);
             } else {
                 // Randomize aiming SIDEWAYS frames -> [0f, 8f]
-                mTimerRight = mpCurrBreak->right = random.NextU32(8);
+                mTimerRight = mpCurrBreak->right = rRandom.NextU32(8);
             }
         }
 
-        // Base cue position
-        mpCurrBreak->pos = EGG::Vector2f(0.015f, 0.15f);
+        break;
+    }
+    }
+
+    mpCurrBreak->style = mStyle;
+
+    RandomizeHit(rRandom);
+}
+
+/**
+ * @brief Randomizes the cue position and power
+ *
+ * @param rRandom Random generator
+ */
+template <typename TRandom> void Simulation::RandomizeHit(TRandom& rRandom) {
+    ASSERT(mpCurrBreak != nullptr);
+
+    // Base cue position
+    mpCurrBreak->pos = EGG::Vector2f(0.015f, 0.15f);
 
-        // Randomize X pos -> [-0.015, +0.015]
-        mpCurrBreak->pos.x *= random.NextF32();
-        // 50% chance to flip
-        mpCurrBreak->pos.x *= random.Sign();
+    // Randomize X pos -> [-0.015, +0.015]
+    mpCurrBreak->pos.x *= rRandom.NextF32();
+    // 50% chance to flip
+    mpCurrBreak->pos.x *= rRandom.Sign();
 
+    switch (mStyle) {
+    case EStyle_Normal: {
+        // Randomize Y pos -> [+0.15, +0.30]
+        mpCurrBreak->pos.y += rRandom.NextF32(0.15f);
+        break;
+    }
+
+    case EStyle_Jump: {
         // Randomize Y pos -> [+0.15, +0.35]
-        mpCurrBreak->pos.y += random.NextF32(0.20f);
+        mpCurrBreak->pos.y += rRandom.NextF32(0.20f);
         break;
     }
     }
+
+    // Default to max power
+    mpCurrBreak->power = POWER_MAX;
+
+    // Randomize power -> [min, max]
+    f32 powerMin = Config::GetInstance().GetForkPowerMin();
+    if (powerMin < POWER_MAX) {
+        mpCurrBreak->power = powerMin + rRandom.NextF32(POWER_MAX - powerMin);
+    }
+}
+
+/**
+ * @brief Takes the aiming and hit from the next parameter space point
+ * @details The style and sequence index are recorded with the break, so it
+ * can be reproduced from them.
+ */
+void Simulation::EnumerateParams() {
+    ASSERT(mpCurrBreak != nullptr);
+
+    if (mpBandit != nullptr) {
+        mStyle = static_cast<EStyle>(mpBandit->Choose() / ESide_Max);
+    } else {
+        // Alternate between styles
+        mStyle = static_cast<EStyle>((mStyle + 1) % EStyle_Max);
+    }
+
+    u64 index = 0;
+    mIsLeased = false;
+
+    // Local sequence is the fallback until the server hands out a lease
+    if (mpLeaseClients[mStyle] != nullptr) {
+        kiwi::Optional<u64> leased = mpLeaseClients[mStyle]->Next();
+
+        if (leased.HasValue()) {
+            index = *leased;
+            mIsLeased = true;
+        }
+    }
+
+    if (!mIsLeased) {
+        ASSERT(mpParamCursors[mStyle] != nullptr);
+        index = mpParamCursors[mStyle]->Next();
+    }
+
+    mpCurrBreak->kseed = 0;
+    mpCurrBreak->source = BreakInfo::ESource_Enumerate;
+    mpCurrBreak->style = mStyle;
+    mpCurrBreak->index = index;
+
+    f32 values[EAxis_Max];
+    mParamSpaces[mStyle].Sample(index, values);
+
+    // Negative UP values leave the cue level
+    if (values[EAxis_Up] > 0.0f) {
+        mpCurrBreak->up = static_cast<s32>(values[EAxis_Up]);
+    }
+
+    // Negative SIDEWAYS values aim left
+    if (values[EAxis_Side] < 0.0f) {
+        mpCurrBreak->left = static_cast<s32>(-values[EAxis_Side]);
+    } else {
+        mpCurrBreak->right = static_cast<s32>(values[EAxis_Side]);
+    }
+
+    mTimerUp = mpCurrBreak->up;
+    mTimerLeft = mpCurrBreak->left;
+    mTimerRight = mpCurrBreak->right;
+
+    mpCurrBreak->pos.x = values[EAxis_PosX];
+    mpCurrBreak->pos.y = values[EAxis_PosY];
+    mpCurrBreak->power = values[EAxis_Power];
+
+    // Sampled point decides the side
+    mArm = mStyle * ESide_Max +
+           (mpCurrBreak->left > 0 ? ESide_Left : ESide_Right);
+}
+
+/**
+ * @brief Prepares the next variant of the current break
+ * @details Variants share the aiming of the current break, so they resume
+ * from the table state when aiming finished. Until restoring that state has
+ * reproduced enough whole breaks, the only variant is a re-run of the
+ * checkpointed break.
+ *
+ * @return Whether a variant is ready to simulate
+ */
+bool Simulation::NextVariant() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpCheckpoint != nullptr);
+
+    // New best break must be replayed first
+    if (mIsReplay || !mpCheckpoint->IsValid() || mIsForkFailed) {
+        return false;
+    }
+
+    // Table needs a real reset after an aborted break
+    if (mIsAborted) {
+        return false;
+    }
+
+    if (mVariantNum + 1 >= Config::GetInstance().GetForkNum()) {
+        return false;
+    }
+
+    // Variants are only trusted once the checkpoint reproduces whole breaks
+    if (mForkCheckNum < FORK_CHECK_MIN) {
+        // One check per aiming, and only of breaks that finished
+        if (mIsForkCheck || !mIsForkBreakValid) {
+            return false;
+        }
+
+        mVariantNum++;
+        mIsForkCheck = true;
+
+        mpCheckpoint->Restore();
+        RPUtlRandom::setSeed(mCheckpointSeed);
+
+        // Same hit as the checkpointed break
+        *mpCurrBreak = *mpForkBreak;
+        mpCurrBreak->frame = mCheckpointFrame - 1;
+
+        StartBreak();
+
+        mIsFinished = false;
+        return true;
+    }
+
+    mVariantNum++;
+    mIsForkCheck = false;
+
+    // New hits are not candidates of the local search
+    mIsLocal = false;
+    // Lease results cover the leased index only, not its variants
+    mIsLeased = false;
+
+    mpCheckpoint->Restore();
+    RPUtlRandom::setSeed(mCheckpointSeed);
+
+    // Next tick re-counts the checkpoint frame
+    mpCurrBreak->frame = mCheckpointFrame - 1;
+
+    if (Config::GetInstance().IsPcgRandom()) {
+        TakeSeed(mPcgRandom);
+        RandomizeHit(mPcgRandom);
+    } else {
+        // Seeded by OS clock
+        kiwi::Random random;
+        TakeSeed(random);
+        RandomizeHit(random);
+    }
+
+    StartBreak();
+
+    mIsFinished = false;
+    return true;
 }
 
 /**
@@ -415,32 +1304,65 @@ void Simulation::Tick() {
 
     mpCurrBreak->frame++;
 
+    // Give up on breaks that never reach the end of the shot
+    u32 frameMax = Config::GetInstance().GetFrameMax();
+    if (frameMax > 0 && mpCurrBreak->frame > frameMax) {
+        Abort();
+        return;
+    }
+
+    // End the shot once the table is at rest
+    if (mpSettle != nullptr && !mIsSettled && mpSettle->IsSettled()) {
+        mIsSettled = true;
+        mSettleNum++;
+        mpCensus->Take();
+        mSettleSunk = mpCensus->GetSunkNum();
+        mSettleOff = mpCensus->GetOffNum();
+        mSettleFoul = mpCensus->IsFoul();
+
+        // Frame counts that are used must come from the full shot
+        if (CanFinishSettled()) {
+            mIsSettleFinish = true;
+            Finish();
+            return;
+        }
+    }
+
+    // End hopeless breaks before simulating further
+    if (CanPrune()) {
+        ReportEmpty();
+
+        mIsFirstRun = false;
+        mIsFinished = true;
+        mPruneNum++;
+        return;
+    }
+
     RPBilCtrl* pCtrl = RP_GET_INSTANCE(RPBilCtrlManager)->GetCtrl();
     ASSERT(pCtrl != nullptr);
 
     // TODO: CanCtrl is wrong on the very first scene tick, why?
     if (pCtrl->CanCtrl() && !mIsFirstTick) {
-        // Aim up
-        if (mTimerUp > 0) {
-            mTimerUp--;
-            pCtrl->TurnY(-TURN_SPEED_Y);
+        // Replays always aim frame-by-frame to verify the fast path
+        if (Config::GetInstance().IsFastAim() && !mIsReplay) {
+            FastAim(pCtrl);
+        } else {
+            StepAim(pCtrl);
         }
+    }
 
-        // Aim left
-        if (mTimerLeft > 0) {
-            mTimerLeft--;
-            pCtrl->TurnX(TURN_SPEED_X);
-        }
-        // Aim right
-        else if (mTimerRight > 0) {
-            mTimerRight--;
-            pCtrl->TurnX(-TURN_SPEED_X);
-        }
+    // Checkpoint the table once aiming is done (before the cue is pulled)
+    if (pCtrl->CanCtrl() && IsAimFinish() && !mIsReplay && !mIsSnapshotCheck &&
+        !mIsForkFailed && !mpCheckpoint->IsValid() &&
+        Config::GetInstance().GetForkNum() > 1) {
+        mCheckpointSeed = RPUtlRandom::getSeed();
+        mCheckpointFrame = mpCurrBreak->frame;
+        mpCheckpoint->Capture();
     }
 
     // Pointer coordinates
-    f32 x = mIsReplay ? mpBestBreak->pos.x : mpCurrBreak->pos.x;
-    f32 y = mIsReplay ? mpBestBreak->pos.y : mpCurrBreak->pos.y;
+    f32 x = mIsReplay ? mpReplayBreak->pos.x : mpCurrBreak->pos.x;
+    f32 y = mIsReplay ? mpReplayBreak->pos.y : mpCurrBreak->pos.y;
 
     // Map to screen position
     EGG::Vector2f pos(x * (RPGrpScreen::GetSizeXMax() / 2),
@@ -454,6 +1376,363 @@ void Simulation::Tick() {
     mIsFirstTick = false;
 }
 
+/**
+ * @brief Abandons a break that exceeded the frame limit
+ */
+void Simulation::Abort() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpBestBreak != nullptr);
+
+    K_LOG_EX("Break aborted after %d frames\n", mpCurrBreak->frame);
+
+    // Seeds are needed to reproduce the problem
+    if (mIsReplay) {
+        mpReplayBreak->Log();
+    } else {
+        mpCurrBreak->Log();
+    }
+
+    ReportEmpty();
+
+    // Checkpointed break finished within the limit
+    if (mIsForkCheck) {
+        K_LOG("Variants disabled (fork check aborted)\n");
+        mIsForkFailed = true;
+    }
+
+    // Snapshot break finished within the limit
+    if (mIsSnapshotCheck) {
+        K_LOG("Snapshot disabled (snapshot check aborted)\n");
+        mIsSnapshotFailed = true;
+    }
+
+    mIsFirstRun = false;
+    mIsFinished = true;
+    mIsReplay = false;
+    mIsAborted = true;
+
+    mAbortNum++;
+}
+
+/**
+ * @brief Resets per-break state (for new breaks and variants)
+ */
+void Simulation::StartBreak() {
+    if (mpPruner != nullptr) {
+        mpPruner->Reset();
+    }
+
+    if (mpSettle != nullptr) {
+        mpSettle->Reset();
+    }
+
+    mIsSettled = false;
+    mIsSettleFinish = false;
+    mIsPruned = false;
+}
+
+/**
+ * @brief Reports a break that ended without results (pruned or aborted)
+ * @details The search still has to learn from these breaks, or it keeps
+ * spending time on them, so they are reported as yielding no balls.
+ */
+void Simulation::ReportEmpty() {
+    ASSERT(mpCurrBreak != nullptr);
+
+    // Replays and re-runs are not search results
+    if (mIsReplay || mIsForkCheck || mIsSnapshotCheck) {
+        return;
+    }
+
+    if (mIsLeased) {
+        mpLeaseClients[mStyle]->Record(0, false);
+    }
+
+    if (mIsLocal) {
+        BreakInfo empty = *mpCurrBreak;
+        empty.sunk = 0;
+        empty.off = 0;
+        empty.foul = false;
+        empty.nearMiss = -1.0f;
+
+        mpLocalSearch->Accept(empty);
+        mLocalNum++;
+    } else if (mpBandit != nullptr) {
+        mpBandit->Update(mArm, 0);
+    }
+}
+
+/**
+ * @brief Tests whether the current break can be abandoned
+ */
+bool Simulation::CanPrune() {
+    ASSERT(mpBestBreak != nullptr);
+
+    // Replays, re-runs, and the connection test must run to completion
+    if (mpPruner == nullptr || mIsReplay || mIsForkCheck || mIsSnapshotCheck ||
+        !mIsConnected.HasValue()) {
+        return false;
+    }
+
+    kiwi::Optional<u32> bound = mpPruner->CalcBound();
+    if (!bound) {
+        return false;
+    }
+
+    // Could still be uploaded
+    if (*bound >= UPLOAD_BALL_MIN) {
+        return false;
+    }
+
+    // Could still tie or beat the best break
+    if (*bound >= mpBestBreak->sunk + mpBestBreak->off) {
+        return false;
+    }
+
+    // Validation lets the game finish the shot for comparison
+    if (Config::GetInstance().IsPruneValidate()) {
+        if (!mIsPruned) {
+            mIsPruned = true;
+            mPruneBound = *bound;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Tests whether the current break can end once the table settles
+ * @details The frame count is not final at that point, so this is limited to
+ * breaks whose frame count is never uploaded or compared.
+ */
+bool Simulation::CanFinishSettled() const {
+    ASSERT(mpBestBreak != nullptr);
+
+    // Validation lets the game finish the shot for comparison
+    if (Config::GetInstance().IsSettleValidate()) {
+        return false;
+    }
+
+    // Replays, re-runs, and the connection test must run to completion
+    if (mIsReplay || mIsForkCheck || mIsSnapshotCheck ||
+        !mIsConnected.HasValue()) {
+        return false;
+    }
+
+    u32 ballNum = mSettleSunk + mSettleOff;
+
+    // Uploaded with its frame count
+    if (ballNum >= UPLOAD_BALL_MIN) {
+        return false;
+    }
+
+    // Frame count could break a tie with the best break
+    if (ballNum >= mpBestBreak->sunk + mpBestBreak->off) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Applies one frame of aiming
+ *
+ * @param pCtrl Billiards controller
+ */
+void Simulation::StepAim(RPBilCtrl* pCtrl) {
+    ASSERT(pCtrl != nullptr);
+
+    // Aim up
+    if (mTimerUp > 0) {
+        mTimerUp--;
+        pCtrl->TurnY(-TURN_SPEED_Y);
+    }
+
+    // Aim left
+    if (mTimerLeft > 0) {
+        mTimerLeft--;
+        pCtrl->TurnX(TURN_SPEED_X);
+    }
+    // Aim right
+    else if (mTimerRight > 0) {
+        mTimerRight--;
+        pCtrl->TurnX(-TURN_SPEED_X);
+    }
+}
+
+/**
+ * @brief Applies all remaining aiming in a single tick
+ * @details The turns are applied one step at a time, in the same order as the
+ * frame-by-frame path, so the floating-point results are bit-identical.
+ *
+ * @param pCtrl Billiards controller
+ */
+void Simulation::FastAim(RPBilCtrl* pCtrl) {
+    ASSERT(pCtrl != nullptr);
+    ASSERT(mpCurrBreak != nullptr);
+
+    s32 stepNum = 0;
+    for (; !IsAimFinish(); stepNum++) {
+        StepAim(pCtrl);
+    }
+
+    // Count the skipped frames so the break record matches a replay
+    if (stepNum > 1) {
+        mpCurrBreak->frame += stepNum - 1;
+    }
+}
+
+/**
+ * @brief Verifies the settle detector results against the full shot
+ */
+void Simulation::VerifySettle() {
+    ASSERT(mpCurrBreak != nullptr);
+
+    if (mpSettle == nullptr) {
+        return;
+    }
+
+    // Detector did not fire before the game ended the shot
+    if (!mIsSettled) {
+        K_LOG_EX("Settle not detected (seed %08X, kseed %08X)\n",
+                 mpCurrBreak->seed, mpCurrBreak->kseed);
+        return;
+    }
+
+    if (mSettleSunk == mpCurrBreak->sunk && mSettleOff == mpCurrBreak->off &&
+        mSettleFoul == mpCurrBreak->foul) {
+        return;
+    }
+
+    K_LOG_EX("Settle mismatch (seed %08X, kseed %08X)\n"
+             "    settled:\t%d sunk, %d off, foul:%d\n"
+             "    finished:\t%d sunk, %d off, foul:%d\n",
+             mpCurrBreak->seed, mpCurrBreak->kseed, mSettleSunk, mSettleOff,
+             mSettleFoul, mpCurrBreak->sunk, mpCurrBreak->off,
+             mpCurrBreak->foul);
+
+    mSettleMismatchNum++;
+}
+
+/**
+ * @brief Verifies the pruning bound against the full shot
+ */
+void Simulation::VerifyPrune() {
+    ASSERT(mpCurrBreak != nullptr);
+
+    if (!mIsPruned) {
+        return;
+    }
+
+    u32 ballNum = mpCurrBreak->sunk + mpCurrBreak->off;
+    if (ballNum <= mPruneBound) {
+        return;
+    }
+
+    K_LOG_EX("Prune bound beaten (seed %08X, kseed %08X)\n"
+             "    bound:\t%d balls\n"
+             "    finished:\t%d balls\n",
+             mpCurrBreak->seed, mpCurrBreak->kseed, mPruneBound, ballNum);
+
+    mPruneMismatchNum++;
+}
+
+/**
+ * @brief Verifies the replay results against the replayed break
+ */
+void Simulation::VerifyReplay() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpReplayBreak != nullptr);
+
+    mpCensus->Take();
+    u32 sunk = mpCensus->GetSunkNum();
+    u32 off = mpCensus->GetOffNum();
+    bool foul = mpCensus->IsFoul();
+    u32 frame = mpCurrBreak->frame;
+
+    if (sunk == mpReplayBreak->sunk && off == mpReplayBreak->off &&
+        foul == mpReplayBreak->foul && frame == mpReplayBreak->frame) {
+        return;
+    }
+
+    K_LOG_EX("Replay mismatch (seed %08X)\n"
+             "    got:\t\t%d sunk, %d off, foul:%d, %d frames\n"
+             "    expected:\t%d sunk, %d off, foul:%d, %d frames\n",
+             mpReplayBreak->seed, sunk, off, foul, frame, mpReplayBreak->sunk,
+             mpReplayBreak->off, mpReplayBreak->foul, mpReplayBreak->frame);
+
+    mMismatchNum++;
+}
+
+/**
+ * @brief Verifies the fork check results against the checkpointed break
+ */
+void Simulation::VerifyFork() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpForkBreak != nullptr);
+
+    mpCensus->Take();
+    u32 sunk = mpCensus->GetSunkNum();
+    u32 off = mpCensus->GetOffNum();
+    bool foul = mpCensus->IsFoul();
+    u32 frame = mpCurrBreak->frame;
+
+    if (sunk == mpForkBreak->sunk && off == mpForkBreak->off &&
+        foul == mpForkBreak->foul && frame == mpForkBreak->frame) {
+        if (++mForkCheckNum == FORK_CHECK_MIN) {
+            K_LOG("Variants enabled (checkpoint verified)\n");
+        }
+
+        return;
+    }
+
+    K_LOG_EX("Fork mismatch (seed %08X, kseed %08X)\n"
+             "    got:\t\t%d sunk, %d off, foul:%d, %d frames\n"
+             "    expected:\t%d sunk, %d off, foul:%d, %d frames\n",
+             mpForkBreak->seed, mpForkBreak->kseed, sunk, off, foul, frame,
+             mpForkBreak->sunk, mpForkBreak->off, mpForkBreak->foul,
+             mpForkBreak->frame);
+
+    K_LOG("Variants disabled (checkpoint does not reproduce breaks)\n");
+    mIsForkFailed = true;
+}
+
+/**
+ * @brief Verifies the snapshot check results against the snapshot break
+ */
+void Simulation::VerifySnapshot() {
+    ASSERT(mpCurrBreak != nullptr);
+    ASSERT(mpSnapshotBreak != nullptr);
+
+    mpCensus->Take();
+    u32 sunk = mpCensus->GetSunkNum();
+    u32 off = mpCensus->GetOffNum();
+    bool foul = mpCensus->IsFoul();
+    u32 frame = mpCurrBreak->frame;
+
+    if (sunk == mpSnapshotBreak->sunk && off == mpSnapshotBreak->off &&
+        foul == mpSnapshotBreak->foul && frame == mpSnapshotBreak->frame) {
+        if (++mSnapshotCheckNum == SNAPSHOT_CHECK_MIN) {
+            K_LOG("Snapshot enabled (restoring reproduces breaks)\n");
+        }
+
+        return;
+    }
+
+    K_LOG_EX("Snapshot mismatch (seed %08X, kseed %08X)\n"
+             "    got:\t\t%d sunk, %d off, foul:%d, %d frames\n"
+             "    expected:\t%d sunk, %d off, foul:%d, %d frames\n",
+             mpSnapshotBreak->seed, mpSnapshotBreak->kseed, sunk, off, foul,
+             frame, mpSnapshotBreak->sunk, mpSnapshotBreak->off,
+             mpSnapshotBreak->foul, mpSnapshotBreak->frame);
+
+    K_LOG("Snapshot disabled (restoring does not reproduce breaks)\n");
+    mSnapshotMismatchNum++;
+    mIsSnapshotFailed = true;
+}
+
 /**
  * @brief Commits break results
  */
@@ -464,43 +1743,218 @@ void Simulation::Finish() {
     mIsFirstRun = false;
     mIsFinished = true;
 
-    // Nothing to do if this is a replay
+    // Replays only check determinism
     if (mIsReplay) {
+        VerifyReplay();
         mIsReplay = false;
         return;
     }
 
+    // Fork checks are re-runs, not new breaks
+    if (mIsForkCheck) {
+        VerifyFork();
+        return;
+    }
+
+    // Snapshot checks are re-runs too
+    if (mIsSnapshotCheck) {
+        VerifySnapshot();
+        return;
+    }
+
     // Record break results
-    mpCurrBreak->sunk = GetSunkNum();
-    mpCurrBreak->off = GetOffNum();
-    mpCurrBreak->foul = GetFoul();
+    mpCensus->Take();
+    mpCurrBreak->sunk = mpCensus->GetSunkNum();
+    mpCurrBreak->off = mpCensus->GetOffNum();
+    mpCurrBreak->foul = mpCensus->IsFoul();
+    mpCurrBreak->nearMiss = mpCensus->GetNearMiss();
+
+    // Compare against the early result
+    if (Config::GetInstance().IsSettleValidate()) {
+        VerifySettle();
+    }
+
+    if (Config::GetInstance().IsPruneValidate()) {
+        VerifyPrune();
+    }
+
+    // Keep the checkpointed break until restoring it has been checked
+    if (mpCheckpoint->IsValid() && mVariantNum == 0 && !mIsSettleFinish &&
+        mForkCheckNum < FORK_CHECK_MIN) {
+        *mpForkBreak = *mpCurrBreak;
+        mIsForkBreakValid = true;
+    }
+
+    // Keep a break from a real reset to check the snapshot against
+    if (mIsRealReset && mpSnapshot->IsValid() && !mIsSnapshotFailed &&
+        mVariantNum == 0 && !mIsSettleFinish) {
+        *mpSnapshotBreak = *mpCurrBreak;
+        mIsSnapshotBreakValid = true;
+    }
 
     // Track statistics
     mBreakNum++;
     mBreakBallNum[mpCurrBreak->sunk + mpCurrBreak->off]++;
 
+    // Pick up results from the upload worker
+    if (mpUploadQueue != nullptr) {
+        mpUploadQueue->GetStatus(mIsConnected, mHttpError, mHttpExError,
+                                 mHttpStatus);
+    }
+
     bool upload = false;
     // Always upload 6+ breaks
-    upload |= mpCurrBreak->sunk + mpCurrBreak->off >= 6;
-    // Upload first break to test connection
-    upload |= !mIsConnected.HasValue();
+    upload |= mpCurrBreak->sunk + mpCurrBreak->off >= UPLOAD_BALL_MIN;
+    // Upload first break to test connection (only once if it is queued)
+    upload |= !mIsConnected.HasValue() &&
+              (mpUploadQueue == nullptr || mpUploadQueue->GetPushNum() == 0);
 
     // Upload information to the server
     if (upload) {
-        mIsConnected =
-            mpCurrBreak->Upload(mHttpError, mHttpExError, mHttpStatus);
+        if (mpUploadQueue != nullptr) {
+            mpUploadQueue->Push(*mpCurrBreak);
+        } else {
+            mIsConnected =
+                mpCurrBreak->Upload(mHttpError, mHttpExError, mHttpStatus);
+        }
+    }
+
+    // Leased breaks are reported when the whole lease is done
+    if (mIsLeased) {
+        u32 ballNum = mpCurrBreak->sunk + mpCurrBreak->off;
+
+        // Connection test uploads do not qualify
+        mpLeaseClients[mStyle]->Record(ballNum, ballNum >= UPLOAD_BALL_MIN);
+    }
+
+    if (mIsLocal) {
+        // Candidate results steer the local search
+        mpLocalSearch->Accept(*mpCurrBreak);
+        mLocalNum++;
+    } else if (mpBandit != nullptr) {
+        // Explored results steer the style allocation
+        mpBandit->Update(mArm, mpCurrBreak->sunk + mpCurrBreak->off);
+    }
+
+    // Keep strong breaks that are not the best (ranked by frame count)
+    if (mpLeaderboard != nullptr && !mIsSettleFinish) {
+        mpLeaderboard->Insert(*mpCurrBreak);
+    }
+
+    bool best = mpCurrBreak->IsBetterThan(*mpBestBreak);
+
+    // Keep a local history in case uploads are lost
+    if (mpJournal != nullptr &&
+        (best || mpCurrBreak->sunk + mpCurrBreak->off >= UPLOAD_BALL_MIN)) {
+        mpJournal->Append(*mpCurrBreak);
+
+        // Bests replace best.brk, so they cannot wait for the batch
+        if (best) {
+            mpJournal->Flush();
+        }
     }
 
     // Check for new local best
-    if (mpCurrBreak->IsBetterThan(*mpBestBreak)) {
-        // Record break locally
+    if (best) {
+        // Record break locally (the journal already has it)
         mpCurrBreak->Log();
-        mpCurrBreak->Save("best.brk");
+        if (mpJournal == nullptr) {
+            mpCurrBreak->Save("best.brk");
+        }
 
-        // Prepare replay
         *mpBestBreak = *mpCurrBreak;
+        QueueReplay();
+
+        // Search around breaks that are already good
+        if (mpLocalSearch != nullptr &&
+            mpBestBreak->sunk + mpBestBreak->off >=
+                Config::GetInstance().GetLocalSearchMin()) {
+            mpLocalSearch->SetCenter(*mpBestBreak);
+        }
+    }
+
+    // Periodically checkpoint search progress
+    if (mpResume != nullptr) {
+        u32 interval = Config::GetInstance().GetResumeSec();
+        s64 now = OSGetTime();
+
+        if (now - mResumeTime >= OS_SEC_TO_TICKS(static_cast<s64>(interval))) {
+            SaveResume();
+            mResumeTime = now;
+        }
+    }
+}
+
+/**
+ * @brief Turns the local search around the best break on or off
+ */
+void Simulation::ToggleLocalSearch() {
+    if (mpLocalSearch == nullptr) {
+        return;
+    }
+
+    mpLocalSearch->SetEnabled(!mpLocalSearch->IsEnabled());
+}
+
+/**
+ * @brief Schedules the replay of a new best break
+ */
+void Simulation::QueueReplay() {
+    ASSERT(mpBestBreak != nullptr);
+    ASSERT(mpReplayBreak != nullptr);
+    ASSERT(mpReplayQueue != nullptr);
+
+    switch (Config::GetInstance().GetReplayPolicy()) {
+    case Config::EReplayPolicy_Skip: {
+        break;
+    }
+
+    case Config::EReplayPolicy_Defer: {
+        // Drop the oldest replay to make room
+        if (mReplayQueueNum >= REPLAY_QUEUE_MAX) {
+            for (u32 i = 1; i < REPLAY_QUEUE_MAX; i++) {
+                mpReplayQueue[i - 1] = mpReplayQueue[i];
+            }
+
+            mReplayQueueNum--;
+        }
+
+        mpReplayQueue[mReplayQueueNum++] = *mpBestBreak;
+        break;
+    }
+
+    default: {
+        *mpReplayBreak = *mpBestBreak;
         mIsReplay = true;
+        break;
+    }
     }
 }
 
+/**
+ * @brief Starts the oldest deferred replay
+ *
+ * @return Whether a replay was started
+ */
+bool Simulation::StartDeferredReplay() {
+    ASSERT(mpReplayBreak != nullptr);
+    ASSERT(mpReplayQueue != nullptr);
+
+    if (mReplayQueueNum == 0 || mIsReplay) {
+        return false;
+    }
+
+    *mpReplayBreak = mpReplayQueue[0];
+
+    for (u32 i = 1; i < mReplayQueueNum; i++) {
+        mpReplayQueue[i - 1] = mpReplayQueue[i];
+    }
+
+    mReplayQueueNum--;
+
+    mIsReplay = true;
+    ResetTable();
+    return true;
+}
+
 } // namespace BAH
@@ -1,6 +1,21 @@
 #ifndef BAH_CLIENT_CORE_SIMULATION_H
 #define BAH_CLIENT_CORE_SIMULATION_H
+#include "core/BallCensus.h"
 #include "core/BreakInfo.h"
+#include "core/BreakJournal.h"
+#include "core/ExploredIndex.h"
+#include "core/IBreakPruner.h"
+#include "core/Leaderboard.h"
+#include "core/LeaseClient.h"
+#include "core/LocalSearch.h"
+#include "core/ParamCursor.h"
+#include "core/ParamSpace.h"
+#include "core/ResumeFile.h"
+#include "core/SeedSchedule.h"
+#include "core/SettleDetector.h"
+#include "core/StyleBandit.h"
+#include "core/TableSnapshot.h"
+#include "core/UploadQueue.h"
 
 #include <Pack/RPGraphics.h>
 #include <Pack/RPParty.h>
@@ -21,6 +36,11 @@ class Simulation : public kiwi::DynamicSingleton<Simulation>,
     friend class kiwi::DynamicSingleton<Simulation>;
 
 public:
+    /**
+     * @brief Resets the table for the next break
+     */
+    void ResetTable();
+
     /**
      * @brief Logic before scene reset
      */
@@ -38,6 +58,27 @@ public:
      * @brief Commits break results
      */
     void Finish();
+    /**
+     * @brief Prepares the next variant of the current break
+     *
+     * @return Whether a variant is ready to simulate
+     */
+    bool NextVariant();
+    /**
+     * @brief Starts the oldest deferred replay
+     *
+     * @return Whether a replay was started
+     */
+    bool StartDeferredReplay();
+    /**
+     * @brief Turns the local search around the best break on or off
+     */
+    void ToggleLocalSearch();
+
+    /**
+     * @brief Logs a one-line session summary to the console
+     */
+    void LogStatus() const;
 
     /**
      * @brief Accesses the user's unique ID
@@ -65,7 +106,7 @@ public:
      * @brief Accesses the cue's shot power
      */
     f32 GetCuePower() const {
-        return mpCurrBreak->power;
+        return mIsReplay ? mpReplayBreak->power : mpCurrBreak->power;
     }
 
     /**
@@ -98,6 +139,29 @@ private:
         EStyle_Max
     };
 
+    /**
+     * @brief Sideways aiming direction (bandit sub-region of a style)
+     */
+    enum ESide {
+        ESide_Left,  //!< Aim left (or not sideways)
+        ESide_Right, //!< Aim right (or not sideways)
+
+        ESide_Max
+    };
+
+    /**
+     * @brief Parameter space axis
+     */
+    enum EAxis {
+        EAxis_Up,    //!< Aiming UP frames (negative for none)
+        EAxis_Side,  //!< Aiming SIDEWAYS frames (negative for left)
+        EAxis_PosX,  //!< Cue X position
+        EAxis_PosY,  //!< Cue Y position
+        EAxis_Power, //!< Cue power
+
+        EAxis_Max
+    };
+
     //! Horizontal turn speed
     static const f32 TURN_SPEED_X;
     //! Vertical turn speed
@@ -106,6 +170,29 @@ private:
     //! Maximum cue power
     static const f32 POWER_MAX;
 
+    //! Minimum ball count (sunk + off) that is always uploaded
+    static const u32 UPLOAD_BALL_MIN = 6;
+
+    //! Matching fork checks required before variants are simulated
+    static const u32 FORK_CHECK_MIN = 8;
+    //! Matching snapshot checks required before restores replace resets
+    static const u32 SNAPSHOT_CHECK_MIN = 8;
+
+    //! Maximum number of deferred replays
+    static const u32 REPLAY_QUEUE_MAX = 8;
+
+    //! Maximum redraws of an explored configuration
+    static const u32 REDRAW_MAX = 8;
+
+    //! Number of leaderboard breaks shown on screen
+    static const u32 LEADERBOARD_DRAW_NUM = 5;
+
+    //! Layout version of the resume checkpoint
+    static const u32 RESUME_VERSION = 7;
+
+    //! PCG32 outputs reserved for each break (far more than one draws)
+    static const u32 PCG_BREAK_STRIDE = 64;
+
 private:
     /**
      * @brief Constructor
@@ -122,11 +209,124 @@ private:
      * @param pScene Current scene
      */
     virtual void Configure(RPSysScene* pScene);
+    /**
+     * @brief Exit callback
+     *
+     * @param pScene Current scene
+     */
+    virtual void Exit(RPSysScene* pScene);
     /**
      * @brief Standard draw pass
      */
     virtual void UserDraw();
 
+    /**
+     * @brief Abandons a break that exceeded the frame limit
+     */
+    void Abort();
+    /**
+     * @brief Resets per-break state (for new breaks and variants)
+     */
+    void StartBreak();
+    /**
+     * @brief Reports a break that ended without results (pruned or aborted)
+     */
+    void ReportEmpty();
+
+    /**
+     * @brief Schedules the replay of a new best break
+     */
+    void QueueReplay();
+
+    /**
+     * @brief Tests whether the current break can be abandoned
+     */
+    bool CanPrune();
+    /**
+     * @brief Tests whether the current break can end once the table settles
+     */
+    bool CanFinishSettled() const;
+
+    /**
+     * @brief Accesses the random stream of this instance
+     */
+    u32 GetRandomStream() const {
+        return mUniqueID.HasValue() ? *mUniqueID : 0;
+    }
+
+    /**
+     * @brief Draws a random break, skipping explored configurations
+     *
+     * @param rRandom Random generator
+     */
+    template <typename TRandom> void DrawBreak(TRandom& rRandom);
+    /**
+     * @brief Records the generator state that reproduces the upcoming draws
+     *
+     * @param rRandom Random generator
+     */
+    void TakeSeed(kiwi::Random& rRandom);
+    /**
+     * @brief Moves the generator to the next break and records its position
+     * @details Each break starts its draws at its own position in the
+     * stream, so no two breaks of a session share outputs, and the seed,
+     * stream, and position reproduce any of them.
+     *
+     * @param rRandom Random generator
+     */
+    void TakeSeed(kiwi::PcgRandom& rRandom);
+
+    /**
+     * @brief Randomizes the style, aiming, and hit
+     *
+     * @param rRandom Random generator
+     */
+    template <typename TRandom> void RandomizeBreak(TRandom& rRandom);
+    /**
+     * @brief Randomizes the cue position and power
+     *
+     * @param rRandom Random generator
+     */
+    template <typename TRandom> void RandomizeHit(TRandom& rRandom);
+    /**
+     * @brief Takes the aiming and hit from the next parameter space point
+     */
+    void EnumerateParams();
+
+    /**
+     * @brief Applies one frame of aiming
+     *
+     * @param pCtrl Billiards controller
+     */
+    void StepAim(RPBilCtrl* pCtrl);
+    /**
+     * @brief Applies all remaining aiming in a single tick
+     *
+     * @param pCtrl Billiards controller
+     */
+    void FastAim(RPBilCtrl* pCtrl);
+
+    /**
+     * @brief Verifies the settle detector results against the full shot
+     */
+    void VerifySettle();
+    /**
+     * @brief Verifies the pruning bound against the full shot
+     */
+    void VerifyPrune();
+    /**
+     * @brief Verifies the replay results against the replayed break
+     */
+    void VerifyReplay();
+    /**
+     * @brief Verifies the fork check results against the checkpointed break
+     */
+    void VerifyFork();
+    /**
+     * @brief Verifies the snapshot check results against the snapshot break
+     */
+    void VerifySnapshot();
+
     /**
      * @brief Loads user info (from DVD or NAND)
      */
@@ -136,6 +336,15 @@ private:
      */
     void LoadBreak();
 
+    /**
+     * @brief Restores search progress from the last checkpoint (from NAND)
+     */
+    void LoadResume();
+    /**
+     * @brief Checkpoints search progress (to NAND)
+     */
+    void SaveResume();
+
 private:
     //! User unique ID
     kiwi::Optional<u32> mUniqueID;
@@ -148,6 +357,8 @@ private:
     s32 mHttpExError;
     //! Last HTTP status code
     kiwi::EHttpStatus mHttpStatus;
+    //! Background uploads
+    UploadQueue* mpUploadQueue;
 
     //! Frames to aim up
     s32 mTimerUp;
@@ -160,6 +371,112 @@ private:
     BreakInfo* mpCurrBreak;
     //! Best break information
     BreakInfo* mpBestBreak;
+    //! Break being replayed
+    BreakInfo* mpReplayBreak;
+
+    //! Deferred replays (oldest first)
+    BreakInfo* mpReplayQueue;
+    //! Number of deferred replays
+    u32 mReplayQueueNum;
+
+    //! Table state after the first reset
+    TableSnapshot* mpSnapshot;
+    //! Whether this break started from a real reset
+    bool mIsRealReset;
+    //! Break from a real reset that the snapshot is checked against
+    BreakInfo* mpSnapshotBreak;
+    //! Whether the snapshot break finished (and can be checked)
+    bool mIsSnapshotBreakValid;
+    //! Whether the current break re-runs the snapshot break from the snapshot
+    bool mIsSnapshotCheck;
+    //! Number of snapshot checks that matched their break
+    u32 mSnapshotCheckNum;
+    //! Whether the snapshot cannot stand in for real resets
+    bool mIsSnapshotFailed;
+    //! Table state after aiming
+    TableSnapshot* mpCheckpoint;
+    //! RPUtlRandom seed after aiming
+    u32 mCheckpointSeed;
+    //! Frame count after aiming
+    u32 mCheckpointFrame;
+    //! Variants simulated from the current checkpoint
+    u32 mVariantNum;
+    //! Break the current checkpoint was taken from
+    BreakInfo* mpForkBreak;
+    //! Whether the checkpointed break finished (and can be checked)
+    bool mIsForkBreakValid;
+    //! Whether the current variant re-runs the checkpointed break
+    bool mIsForkCheck;
+    //! Number of fork checks that matched their break
+    u32 mForkCheckNum;
+    //! Whether a fork check failed (variants are disabled)
+    bool mIsForkFailed;
+
+    //! Current randomization style
+    EStyle mStyle;
+
+    //! Parameter space of each style
+    ParamSpace mParamSpaces[EStyle_Max];
+    //! Parameter space position of each style
+    ParamCursor* mpParamCursors[EStyle_Max];
+    //! Server leases of each style's parameter space
+    LeaseClient* mpLeaseClients[EStyle_Max];
+    //! Whether the current break came from a server lease
+    bool mIsLeased;
+
+    //! Search around the best break
+    LocalSearch* mpLocalSearch;
+    //! Whether the current break searches around the best break
+    bool mIsLocal;
+
+    //! Allocation of breaks between styles
+    StyleBandit* mpBandit;
+    //! Bandit arm (style and side) of the current break
+    u32 mArm;
+
+    //! Configurations that were already simulated
+    ExploredIndex* mpExplored;
+
+    //! Scheduled RPUtlRandom seeds
+    SeedSchedule* mpSeedSchedule;
+
+    //! Best breaks found so far
+    Leaderboard* mpLeaderboard;
+    //! History of qualifying breaks
+    BreakJournal* mpJournal;
+
+    //! Search progress checkpoint
+    ResumeFile* mpResume;
+    //! Time of the last checkpoint
+    s64 mResumeTime;
+
+    //! PCG32 generator for random breaks
+    kiwi::PcgRandom mPcgRandom;
+    //! Stream position of the next break
+    u64 mPcgPosition;
+
+    //! Hopeless break predicate
+    IBreakPruner* mpPruner;
+    //! Whether this break would have been pruned (validation)
+    bool mIsPruned;
+    //! Ball count bound when this break would have been pruned (validation)
+    u32 mPruneBound;
+
+    //! Final ball states
+    BallCensus* mpCensus;
+
+    //! Early end-of-shot detector
+    SettleDetector* mpSettle;
+    //! Whether the table has settled this break
+    bool mIsSettled;
+    //! Whether this break ended when the table settled (frame is not final)
+    bool mIsSettleFinish;
+    //! Balls sunk when the table settled
+    u32 mSettleSunk;
+    //! Balls off the table when the table settled
+    u32 mSettleOff;
+    //! Foul status when the table settled
+    bool mSettleFoul;
 
     //! Whether this is the first break
     bool mIsFirstRun;
@@ -170,11 +487,29 @@ private:
     bool mIsReplay;
     //! Whether this break has finished
     bool mIsFinished;
+    //! Whether this break was abandoned
+    bool mIsAborted;
 
     //! Total number of breaks
     u32 mBreakNum;
     //! Total number of breaks by ball count
     u32 mBreakBallNum[RPBilBallManager::BALL_MAX];
+    //! Total number of breaks ended early
+    u32 mPruneNum;
+    //! Total number of breaks abandoned at the frame limit
+    u32 mAbortNum;
+    //! Total number of breaks searched around the best break
+    u32 mLocalNum;
+    //! Total number of replays that did not match their record
+    u32 mMismatchNum;
+    //! Total number of snapshot checks that did not match their break
+    u32 mSnapshotMismatchNum;
+    //! Total number of settled results that did not match the full shot
+    u32 mSettleMismatchNum;
+    //! Total number of pruned breaks that beat their bound
+    u32 mPruneMismatchNum;
+    //! Total number of breaks where the table settled before the shot ended
+    u32 mSettleNum;
 };
 
 } // namespace BAH
@@ -0,0 +1,200 @@
+#include "core/StyleBandit.h"
+
+#include "core/NandUtil.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param armNum Number of arms
+ * @param yieldMin Minimum ball count (sunk + off) of a yield
+ * @param floor Fraction of arms picked uniformly
+ */
+StyleBandit::StyleBandit(u32 armNum, u32 yieldMin, f32 floor)
+    : mArmNum(armNum),
+      mYieldMin(yieldMin),
+      mFloor(floor),
+      mIsDirty(false),
+      mSaveTime(OSGetTime()) {
+
+    ASSERT(mArmNum > 0 && mArmNum <= ARM_MAX);
+    ASSERT(mYieldMin < RPBilBallManager::BALL_MAX);
+
+    std::memset(mBreakBallNum, 0, sizeof(mBreakBallNum));
+    Load();
+}
+
+/**
+ * @brief Destructor
+ */
+StyleBandit::~StyleBandit() {
+    Flush();
+}
+
+/**
+ * @brief Picks the arm of the next break
+ */
+u32 StyleBandit::Choose() {
+    // Keep exploring every arm
+    if (mRandom.NextF32() < mFloor) {
+        return mRandom.NextU32(mArmNum);
+    }
+
+    u32 best = 0;
+    f32 bestSample = 0.0f;
+
+    for (u32 i = 0; i < mArmNum; i++) {
+        f32 n = static_cast<f32>(GetBreakNum(i));
+        f32 s = static_cast<f32>(GetYieldNum(i));
+
+        // Normal approximation of the Beta(s + 1, n - s + 1) posterior
+        f32 mean = (s + 1.0f) / (n + 2.0f);
+        f32 var = mean * (1.0f - mean) / (n + 3.0f);
+        f32 sample = mean + static_cast<f32>(std::sqrt(var)) * NextNormal();
+
+        if (i == 0 || sample > bestSample) {
+            best = i;
+            bestSample = sample;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Records the result of a break
+ *
+ * @param arm Arm of the break
+ * @param ballNum Balls sunk or off the table
+ */
+void StyleBandit::Update(u32 arm, u32 ballNum) {
+    ASSERT(arm < mArmNum);
+    ASSERT(ballNum < RPBilBallManager::BALL_MAX);
+
+    mBreakBallNum[arm][ballNum]++;
+    mIsDirty = true;
+
+    // Saving blocks the search, so at most one interval of breaks is lost
+    s64 interval = OS_SEC_TO_TICKS(static_cast<s64>(SAVE_SEC));
+    if (OSGetTime() - mSaveTime >= interval) {
+        Flush();
+    }
+}
+
+/**
+ * @brief Saves statistics that changed since the last save (to NAND)
+ */
+void StyleBandit::Flush() {
+    if (!mIsDirty) {
+        return;
+    }
+
+    Save();
+
+    mIsDirty = false;
+    mSaveTime = OSGetTime();
+}
+
+/**
+ * @brief Accesses the number of breaks of an arm
+ *
+ * @param arm Arm index
+ */
+u32 StyleBandit::GetBreakNum(u32 arm) const {
+    ASSERT(arm < mArmNum);
+
+    u32 num = 0;
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        num += mBreakBallNum[arm][i];
+    }
+
+    return num;
+}
+
+/**
+ * @brief Accesses the number of yields of an arm
+ *
+ * @param arm Arm index
+ */
+u32 StyleBandit::GetYieldNum(u32 arm) const {
+    ASSERT(arm < mArmNum);
+
+    u32 num = 0;
+    for (int i = mYieldMin; i < RPBilBallManager::BALL_MAX; i++) {
+        num += mBreakBallNum[arm][i];
+    }
+
+    return num;
+}
+
+/**
+ * @brief Draws from a standard normal distribution
+ * @details Sum of twelve uniforms (Irwin-Hall), as there is no log for the
+ * Box-Muller transform.
+ */
+f32 StyleBandit::NextNormal() {
+    f32 sum = 0.0f;
+
+    for (int i = 0; i < 12; i++) {
+        sum += mRandom.NextF32();
+    }
+
+    return sum - 6.0f;
+}
+
+/**
+ * @brief Loads the statistics (from NAND)
+ */
+void StyleBandit::Load() {
+    kiwi::MemStream strm =
+        kiwi::FileRipper::Open("bandit.bin", kiwi::EStorage_NAND);
+
+    if (!strm.IsOpen()) {
+        return;
+    }
+
+    // Arms have changed since the statistics were saved
+    if (strm.Read_u32() != mArmNum) {
+        K_LOG("Discarding old bandit statistics\n");
+        return;
+    }
+
+    for (u32 i = 0; i < mArmNum; i++) {
+        for (int j = 0; j < RPBilBallManager::BALL_MAX; j++) {
+            mBreakBallNum[i][j] = strm.Read_u32();
+        }
+    }
+}
+
+/**
+ * @brief Saves the statistics (to NAND)
+ */
+void StyleBandit::Save() const {
+    kiwi::WorkBufferArg arg;
+    arg.size = sizeof(u32) + sizeof(mBreakBallNum);
+    kiwi::WorkBuffer buffer(arg);
+
+    // Write statistics to buffer
+    {
+        kiwi::MemStream strm(buffer);
+        strm.Write_u32(mArmNum);
+
+        for (u32 i = 0; i < mArmNum; i++) {
+            for (int j = 0; j < RPBilBallManager::BALL_MAX; j++) {
+                strm.Write_u32(mBreakBallNum[i][j]);
+            }
+        }
+    }
+
+    // Save statistics to the NAND
+    WriteNandFile("bandit.bin", buffer);
+}
+
+} // namespace BAH
@@ -0,0 +1,111 @@
+#ifndef BAH_CLIENT_CORE_STYLE_BANDIT_H
+#define BAH_CLIENT_CORE_STYLE_BANDIT_H
+#include <Pack/RPParty.h>
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Allocates breaks between styles (arms) by their yield
+ * @details Arms are picked by Thompson sampling on the rate of breaks that
+ * reach the yield ball count. A fixed fraction of breaks still picks an arm
+ * uniformly, so no arm is starved. Statistics are kept on the NAND, and are
+ * written at most once per interval so the search rarely waits on it.
+ */
+class StyleBandit {
+public:
+    //! Maximum number of arms
+    static const u32 ARM_MAX = 8;
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param armNum Number of arms
+     * @param yieldMin Minimum ball count (sunk + off) of a yield
+     * @param floor Fraction of arms picked uniformly
+     */
+    StyleBandit(u32 armNum, u32 yieldMin, f32 floor);
+    /**
+     * @brief Destructor
+     */
+    ~StyleBandit();
+
+    /**
+     * @brief Picks the arm of the next break
+     */
+    u32 Choose();
+    /**
+     * @brief Records the result of a break
+     *
+     * @param arm Arm of the break
+     * @param ballNum Balls sunk or off the table
+     */
+    void Update(u32 arm, u32 ballNum);
+    /**
+     * @brief Saves statistics that changed since the last save (to NAND)
+     */
+    void Flush();
+
+    /**
+     * @brief Accesses the number of arms
+     */
+    u32 GetArmNum() const {
+        return mArmNum;
+    }
+
+    /**
+     * @brief Accesses the number of breaks of an arm
+     *
+     * @param arm Arm index
+     */
+    u32 GetBreakNum(u32 arm) const;
+    /**
+     * @brief Accesses the number of yields of an arm
+     *
+     * @param arm Arm index
+     */
+    u32 GetYieldNum(u32 arm) const;
+
+private:
+    //! Minimum time between saves of the statistics (in seconds)
+    static const u32 SAVE_SEC = 60;
+
+private:
+    /**
+     * @brief Draws from a standard normal distribution
+     */
+    f32 NextNormal();
+
+    /**
+     * @brief Loads the statistics (from NAND)
+     */
+    void Load();
+    /**
+     * @brief Saves the statistics (to NAND)
+     */
+    void Save() const;
+
+private:
+    //! Number of arms
+    u32 mArmNum;
+    //! Minimum ball count of a yield
+    u32 mYieldMin;
+    //! Fraction of arms picked uniformly
+    f32 mFloor;
+
+    //! Breaks of each arm by ball count
+    u32 mBreakBallNum[ARM_MAX][RPBilBallManager::BALL_MAX];
+    //! Whether the statistics changed since they were saved
+    bool mIsDirty;
+    //! Time of the last save
+    s64 mSaveTime;
+
+    //! Random generator
+    kiwi::Random mRandom;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,125 @@
+#include "core/TableSnapshot.h"
+
+#include <Pack/RPParty.h>
+#include <Pack/RPUtility.h>
+
+#include <libkiwi.h>
+
+#include <cstring>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ */
+TableSnapshot::TableSnapshot() : mRegionNum(0), mIsValid(false) {
+
+    std::memset(mRegions, 0, sizeof(mRegions));
+}
+
+/**
+ * @brief Destructor
+ */
+TableSnapshot::~TableSnapshot() {
+    Clear();
+}
+
+/**
+ * @brief Captures the current table state
+ */
+void TableSnapshot::Capture() {
+    // Buffers are kept between captures
+    mRegionNum = 0;
+    mIsValid = false;
+
+    RPBilBallManager* pBallMgr = RP_GET_INSTANCE(RPBilBallManager);
+    ASSERT(pBallMgr != nullptr);
+    Register(pBallMgr, sizeof(RPBilBallManager));
+
+    for (int i = 0; i < RPBilBallManager::BALL_MAX; i++) {
+        RPBilBall* pBall = pBallMgr->GetBall(i);
+        ASSERT(pBall != nullptr);
+
+        Register(pBall, sizeof(RPBilBall));
+        Register(pBall->GetStateMachine(), sizeof(RPUtlBaseFsm<RPBilBall>));
+    }
+
+    RPBilCueManager* pCueMgr = RP_GET_INSTANCE(RPBilCueManager);
+    ASSERT(pCueMgr != nullptr);
+    Register(pCueMgr, sizeof(RPBilCueManager));
+
+    RPBilCue* pCue = pCueMgr->GetCue(0);
+    ASSERT(pCue != nullptr);
+    Register(pCue, sizeof(RPBilCue));
+    Register(pCue->GetStateMachine(), sizeof(RPUtlBaseFsm<RPBilCue>));
+
+    RPBilCtrlManager* pCtrlMgr = RP_GET_INSTANCE(RPBilCtrlManager);
+    ASSERT(pCtrlMgr != nullptr);
+    Register(pCtrlMgr, sizeof(RPBilCtrlManager));
+
+    RPBilCtrl* pCtrl = pCtrlMgr->GetCtrl();
+    ASSERT(pCtrl != nullptr);
+    Register(pCtrl, sizeof(RPBilCtrl));
+
+    RPBilMain* pMain = RP_GET_INSTANCE(RPBilMain);
+    ASSERT(pMain != nullptr);
+    Register(pMain, sizeof(RPBilMain));
+    Register(pMain->GetStateMachine(), sizeof(RPUtlBaseFsm<RPBilMain>));
+
+    mIsValid = true;
+}
+
+/**
+ * @brief Restores the captured table state
+ */
+void TableSnapshot::Restore() const {
+    ASSERT(mIsValid);
+
+    for (int i = 0; i < mRegionNum; i++) {
+        std::memcpy(mRegions[i].pAddr, mRegions[i].pData, mRegions[i].size);
+    }
+}
+
+/**
+ * @brief Registers a memory region for capture
+ *
+ * @param pAddr Live object address
+ * @param size Region size
+ */
+void TableSnapshot::Register(void* pAddr, u32 size) {
+    ASSERT(pAddr != nullptr);
+    ASSERT(size > 0);
+    ASSERT(mRegionNum < REGION_MAX);
+
+    Region& rRegion = mRegions[mRegionNum++];
+    rRegion.pAddr = pAddr;
+
+    // Reallocate only if the previous buffer is the wrong size
+    if (rRegion.pData != nullptr && rRegion.size != size) {
+        delete[] rRegion.pData;
+        rRegion.pData = nullptr;
+    }
+
+    if (rRegion.pData == nullptr) {
+        rRegion.pData = new (32, kiwi::EMemory_MEM2) u8[size];
+        ASSERT(rRegion.pData != nullptr);
+    }
+
+    rRegion.size = size;
+    std::memcpy(rRegion.pData, pAddr, size);
+}
+
+/**
+ * @brief Releases all captured regions
+ */
+void TableSnapshot::Clear() {
+    for (int i = 0; i < REGION_MAX; i++) {
+        delete[] mRegions[i].pData;
+        mRegions[i].pData = nullptr;
+    }
+
+    mRegionNum = 0;
+    mIsValid = false;
+}
+
+} // namespace BAH
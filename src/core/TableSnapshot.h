@@ -0,0 +1,88 @@
+#ifndef BAH_CLIENT_CORE_TABLE_SNAPSHOT_H
+#define BAH_CLIENT_CORE_TABLE_SNAPSHOT_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Copy of the Billiards table state
+ * @details Captures explicitly registered regions of the Billiards managers,
+ * balls, cue, controller, main object, and their state machines. Only the
+ * members mapped in the headers are known, so restoring is not assumed to be
+ * equivalent to the real thing: callers must check it by re-running whole
+ * breaks (see Simulation::VerifySnapshot and Simulation::VerifyFork).
+ */
+class TableSnapshot {
+public:
+    /**
+     * @brief Constructor
+     */
+    TableSnapshot();
+    /**
+     * @brief Destructor
+     */
+    ~TableSnapshot();
+
+    /**
+     * @brief Captures the current table state
+     */
+    void Capture();
+    /**
+     * @brief Restores the captured table state
+     */
+    void Restore() const;
+
+    /**
+     * @brief Discards the captured table state
+     */
+    void Invalidate() {
+        mIsValid = false;
+    }
+
+    /**
+     * @brief Tests whether the snapshot holds a valid table state
+     */
+    bool IsValid() const {
+        return mIsValid;
+    }
+
+private:
+    /**
+     * @brief Captured memory region
+     */
+    struct Region {
+        void* pAddr; //!< Live object address
+        u32 size;    //!< Region size
+        u8* pData;   //!< Captured contents
+    };
+
+    //! Maximum number of captured regions
+    static const int REGION_MAX = 32;
+
+private:
+    /**
+     * @brief Registers a memory region for capture
+     *
+     * @param pAddr Live object address
+     * @param size Region size
+     */
+    void Register(void* pAddr, u32 size);
+    /**
+     * @brief Releases all captured regions
+     */
+    void Clear();
+
+private:
+    //! Captured regions
+    Region mRegions[REGION_MAX];
+    //! Number of captured regions
+    int mRegionNum;
+
+    //! Whether a table state has been captured
+    bool mIsValid;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,63 @@
+#include "core/Unthrottle.h"
+
+#include <egg/core.h>
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ */
+Unthrottle::Unthrottle()
+    : mRetraceWait(0),
+      mIsEnabled(false),
+      mFrameNum(0),
+      mRateTime(OSGetTime()),
+      mFrameRate(0.0f) {}
+
+/**
+ * @brief Counts one main loop frame
+ */
+void Unthrottle::Calculate() {
+    mFrameNum++;
+
+    s64 now = OSGetTime();
+    s64 elapsed = now - mRateTime;
+
+    if (elapsed < OS_SEC_TO_TICKS(static_cast<s64>(RATE_SEC))) {
+        return;
+    }
+
+    mFrameRate = mFrameNum * 1000.0f / OS_TICKS_TO_MSEC(elapsed);
+    mFrameNum = 0;
+    mRateTime = now;
+}
+
+/**
+ * @brief Clears or restores the display's retrace wait
+ *
+ * @param enable Whether frames should skip the retrace wait
+ */
+void Unthrottle::Set(bool enable) {
+    if (enable == mIsEnabled) {
+        return;
+    }
+
+    // Returns the AsyncDisplay created by RPSysSystem
+    EGG::Display* pDisplay = EGG::BaseSystem::getDisplay();
+    ASSERT(pDisplay != nullptr);
+
+    // Frames sleep until this many retraces have passed
+    if (enable) {
+        mRetraceWait = pDisplay->mRetraceWait;
+        pDisplay->mRetraceWait = 0;
+    } else {
+        pDisplay->mRetraceWait = mRetraceWait;
+    }
+
+    mIsEnabled = enable;
+}
+
+} // namespace BAH
@@ -0,0 +1,71 @@
+#ifndef BAH_CLIENT_CORE_UNTHROTTLE_H
+#define BAH_CLIENT_CORE_UNTHROTTLE_H
+#include <libkiwi.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Lets the main loop run faster than the display refresh rate
+ * @details The game paces its frames through EGG::AsyncDisplay, which sleeps
+ * until the display's retrace wait has passed. Clearing the wait lets the
+ * next frame start as soon as the previous one is done. The main loop rate is
+ * measured either way, so the effect can be checked.
+ */
+class Unthrottle : public kiwi::StaticSingleton<Unthrottle> {
+    friend class kiwi::StaticSingleton<Unthrottle>;
+
+public:
+    /**
+     * @brief Counts one main loop frame
+     */
+    void Calculate();
+
+    /**
+     * @brief Clears or restores the display's retrace wait
+     *
+     * @param enable Whether frames should skip the retrace wait
+     */
+    void Set(bool enable);
+
+    /**
+     * @brief Tests whether frames skip the retrace wait
+     */
+    bool IsEnabled() const {
+        return mIsEnabled;
+    }
+
+    /**
+     * @brief Accesses the measured main loop rate, in frames per second
+     */
+    f32 GetFrameRate() const {
+        return mFrameRate;
+    }
+
+private:
+    //! Interval between frame rate measurements (in seconds)
+    static const u32 RATE_SEC = 1;
+
+private:
+    /**
+     * @brief Constructor
+     */
+    Unthrottle();
+
+private:
+    //! Display's original retrace wait
+    u8 mRetraceWait;
+    //! Whether frames skip the retrace wait
+    bool mIsEnabled;
+
+    //! Frames counted since the last measurement
+    u32 mFrameNum;
+    //! Time of the last measurement
+    s64 mRateTime;
+    //! Measured main loop rate
+    f32 mFrameRate;
+};
+
+} // namespace BAH
+
+#endif
@@ -0,0 +1,156 @@
+#include "core/UploadQueue.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+
+namespace BAH {
+
+/**
+ * @brief Constructor
+ *
+ * @param capacity Maximum number of queued breaks
+ */
+UploadQueue::UploadQueue(u32 capacity)
+    : mCapacity(capacity),
+      mpBreaks(nullptr),
+      mHead(0),
+      mNum(0),
+      mpMessages(nullptr),
+      mIsExit(false),
+      mPushNum(0),
+      mDropNum(0),
+      mIsConnected(),
+      mHttpError(kiwi::EHttpErr_Success),
+      mHttpExError(0),
+      mHttpStatus(kiwi::EHttpStatus_None),
+      mpThread(nullptr) {
+
+    ASSERT(mCapacity > 0);
+
+    mpBreaks = new (32, kiwi::EMemory_MEM2) BreakInfo[mCapacity];
+    ASSERT(mpBreaks != nullptr);
+
+    // One message per break, so sending never blocks
+    mpMessages = new (32, kiwi::EMemory_MEM2) OSMessage[mCapacity];
+    ASSERT(mpMessages != nullptr);
+
+    OSInitMutex(&mMutex);
+    OSInitMessageQueue(&mMessageQueue, mpMessages, mCapacity);
+
+    // Worker starts immediately, so everything else must be ready
+    mpThread =
+        new (32, kiwi::EMemory_MEM2) kiwi::Thread(&UploadQueue::Run, *this);
+    ASSERT(mpThread != nullptr);
+}
+
+/**
+ * @brief Destructor
+ * @note Waits for the upload in progress to finish
+ */
+UploadQueue::~UploadQueue() {
+    mIsExit = true;
+
+    // Wake the worker ahead of any queued breaks
+    OSJamMessage(&mMessageQueue, nullptr, OS_MSG_BLOCKING);
+    mpThread->Join();
+
+    delete mpThread;
+    mpThread = nullptr;
+
+    delete[] mpMessages;
+    mpMessages = nullptr;
+
+    delete[] mpBreaks;
+    mpBreaks = nullptr;
+}
+
+/**
+ * @brief Queues a copy of a break for upload
+ *
+ * @param rBreak Break
+ * @return Whether the break was queued (false when it was dropped)
+ */
+bool UploadQueue::Push(const BreakInfo& rBreak) {
+    {
+        kiwi::AutoMutexLock lock(mMutex);
+
+        if (mNum >= mCapacity) {
+            mDropNum++;
+            K_LOG_EX("Upload queue full (%u dropped)\n", mDropNum);
+            return false;
+        }
+
+        mpBreaks[(mHead + mNum) % mCapacity] = rBreak;
+        mNum++;
+        mPushNum++;
+    }
+
+    OSSendMessage(&mMessageQueue, nullptr, 0);
+    return true;
+}
+
+/**
+ * @brief Copies the result of the most recent upload
+ *
+ * @param[out] rConnected Server connection status (unchanged before the
+ * first upload finishes)
+ * @param[out] rError HTTP error
+ * @param[out] rExError HTTP extended error
+ * @param[out] rStatus Response status code
+ */
+void UploadQueue::GetStatus(kiwi::Optional<bool>& rConnected,
+                            kiwi::EHttpErr& rError, s32& rExError,
+                            kiwi::EHttpStatus& rStatus) const {
+    kiwi::AutoMutexLock lock(mMutex);
+
+    // Optional has no copy assignment
+    if (mIsConnected.HasValue()) {
+        rConnected = *mIsConnected;
+    }
+
+    rError = mHttpError;
+    rExError = mHttpExError;
+    rStatus = mHttpStatus;
+}
+
+/**
+ * @brief Worker thread function
+ */
+void UploadQueue::Run() {
+    while (true) {
+        OSMessage msg;
+        OSReceiveMessage(&mMessageQueue, &msg, OS_MSG_BLOCKING);
+
+        if (mIsExit) {
+            break;
+        }
+
+        BreakInfo info;
+
+        // Keep the slot until the upload is done so the depth includes it
+        {
+            kiwi::AutoMutexLock lock(mMutex);
+            ASSERT(mNum > 0);
+            info = mpBreaks[mHead];
+        }
+
+        kiwi::EHttpErr error = kiwi::EHttpErr_Success;
+        s32 exError = 0;
+        kiwi::EHttpStatus status = kiwi::EHttpStatus_None;
+        bool success = info.Upload(error, exError, status);
+
+        {
+            kiwi::AutoMutexLock lock(mMutex);
+
+            mHead = (mHead + 1) % mCapacity;
+            mNum--;
+
+            mIsConnected = success;
+            mHttpError = error;
+            mHttpExError = exError;
+            mHttpStatus = status;
+        }
+    }
+}
+
+} // namespace BAH
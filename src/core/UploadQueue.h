@@ -0,0 +1,116 @@
+#ifndef BAH_CLIENT_CORE_UPLOAD_QUEUE_H
+#define BAH_CLIENT_CORE_UPLOAD_QUEUE_H
+#include "core/BreakInfo.h"
+
+#include <libkiwi.h>
+#include <revolution/OS.h>
+#include <types.h>
+
+namespace BAH {
+
+/**
+ * @brief Bounded queue of breaks uploaded by a worker thread
+ * @details Uploads can take several seconds each when the server is slow or
+ * down, so they are sent on their own thread instead of the game's. Breaks
+ * that arrive while the queue is full are dropped and counted.
+ */
+class UploadQueue {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param capacity Maximum number of queued breaks
+     */
+    explicit UploadQueue(u32 capacity);
+    /**
+     * @brief Destructor
+     * @note Waits for the upload in progress to finish
+     */
+    ~UploadQueue();
+
+    /**
+     * @brief Queues a copy of a break for upload
+     *
+     * @param rBreak Break
+     * @return Whether the break was queued (false when it was dropped)
+     */
+    bool Push(const BreakInfo& rBreak);
+
+    /**
+     * @brief Copies the result of the most recent upload
+     *
+     * @param[out] rConnected Server connection status (unchanged before the
+     * first upload finishes)
+     * @param[out] rError HTTP error
+     * @param[out] rExError HTTP extended error
+     * @param[out] rStatus Response status code
+     */
+    void GetStatus(kiwi::Optional<bool>& rConnected, kiwi::EHttpErr& rError,
+                   s32& rExError, kiwi::EHttpStatus& rStatus) const;
+
+    /**
+     * @brief Accesses the number of breaks waiting to be uploaded
+     * @note Includes the break currently being uploaded
+     */
+    u32 GetDepth() const {
+        return mNum;
+    }
+    /**
+     * @brief Accesses the number of breaks accepted by the queue
+     */
+    u32 GetPushNum() const {
+        return mPushNum;
+    }
+    /**
+     * @brief Accesses the number of breaks dropped because the queue was full
+     */
+    u32 GetDropNum() const {
+        return mDropNum;
+    }
+
+private:
+    /**
+     * @brief Worker thread function
+     */
+    void Run();
+
+private:
+    //! Maximum number of queued breaks
+    u32 mCapacity;
+    //! Queued breaks (ring buffer)
+    BreakInfo* mpBreaks;
+    //! Index of the oldest queued break
+    u32 mHead;
+    //! Number of queued breaks
+    volatile u32 mNum;
+
+    //! Guards the ring buffer, counters, and upload status
+    mutable OSMutex mMutex;
+    //! Wakes the worker (one message per queued break)
+    OSMessageQueue mMessageQueue;
+    //! Message queue storage
+    OSMessage* mpMessages;
+    //! Whether the worker should stop
+    volatile bool mIsExit;
+
+    //! Number of breaks accepted by the queue
+    volatile u32 mPushNum;
+    //! Number of breaks dropped because the queue was full
+    volatile u32 mDropNum;
+
+    //! Server connection status
+    kiwi::Optional<bool> mIsConnected;
+    //! Last HTTP error
+    kiwi::EHttpErr mHttpError;
+    //! Last HTTP extended error
+    s32 mHttpExError;
+    //! Last HTTP status code
+    kiwi::EHttpStatus mHttpStatus;
+
+    //! Upload worker
+    kiwi::Thread* mpThread;
+};
+
+} // namespace BAH
+
+#endif
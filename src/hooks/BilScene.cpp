@@ -1,8 +1,12 @@
 #include "hooks/BilScene.h"
 
+#include "core/Config.h"
+#include "core/Headless.h"
 #include "core/Simulation.h"
+#include "core/Unthrottle.h"
 
 #include <Pack/RPParty.h>
+#include <libkiwi.h>
 #include <revolution/DSP.h>
 
 namespace BAH {
@@ -21,10 +25,51 @@ void BilScene::CalculateEx() {
         return;
     }
 
+    // Measure the main loop rate
+    Unthrottle::GetInstance().Calculate();
+
     // Replay runs alongside framerate
     if (Simulation::GetInstance().IsReplay()) {
-        Simulation::GetInstance().Tick();
-        RP_GET_INSTANCE(RPBilMain)->Calculate();
+        // Replays run at normal speed
+        Unthrottle::GetInstance().Set(false);
+
+        // Fast-forwarded replays run several ticks per frame
+        u32 tickNum = Config::GetInstance().GetReplayPolicy() ==
+                              Config::EReplayPolicy_Fast
+                          ? Config::GetInstance().GetReplayTicks()
+                          : 1;
+
+        for (u32 i = 0; i < tickNum; i++) {
+            // Game logic may have ended the replay on the previous tick
+            if (Simulation::GetInstance().IsFinished()) {
+                break;
+            }
+
+            Simulation::GetInstance().Tick();
+
+            // Tick may end the replay early
+            if (!Simulation::GetInstance().IsFinished()) {
+                RP_GET_INSTANCE(RPBilMain)->Calculate();
+            }
+        }
+
+        Headless::GetInstance().Calculate();
+        return;
+    }
+
+    const kiwi::WiiCtrl& rCtrl =
+        kiwi::CtrlMgr::GetInstance().GetWiiCtrl(kiwi::EPlayer_1);
+
+    // Local search can be switched while the search runs
+    if (rCtrl.IsTrig(kiwi::EButton_1)) {
+        Simulation::GetInstance().ToggleLocalSearch();
+    }
+
+    // Deferred replays are started from the menu
+    if (rCtrl.IsTrig(kiwi::EButton_A) &&
+        Simulation::GetInstance().StartDeferredReplay()) {
+
+        Headless::GetInstance().Calculate();
         return;
     }
 
@@ -33,21 +78,39 @@ void BilScene::CalculateEx() {
 
     // Need to reset early if this is the first break
     if (Simulation::GetInstance().IsFirstRun()) {
-        Simulation::GetInstance().BeforeReset();
-        RP_GET_INSTANCE(RPBilMain)->Reset();
-        Simulation::GetInstance().AfterReset();
+        Simulation::GetInstance().ResetTable();
     }
 
-    // Simulate the entire break
-    while (!Simulation::GetInstance().IsFinished()) {
-        Simulation::GetInstance().Tick();
-        RP_GET_INSTANCE(RPBilMain)->Calculate();
-    }
+    // Let the main loop run as fast as the search allows
+    Unthrottle::GetInstance().Set(Config::GetInstance().IsUnthrottle());
+
+    // Batch breaks until the frame budget is used up
+    s32 budget = OS_MSEC_TO_TICKS(Config::GetInstance().GetBatchMsec());
+
+    kiwi::Watch watch;
+    watch.Start();
+
+    do {
+        // Simulate the entire break, then its variants
+        do {
+            while (!Simulation::GetInstance().IsFinished()) {
+                Simulation::GetInstance().Tick();
+
+                // Tick may end the break early
+                if (!Simulation::GetInstance().IsFinished()) {
+                    RP_GET_INSTANCE(RPBilMain)->Calculate();
+                }
+            }
+        } while (Simulation::GetInstance().NextVariant());
+
+        // Prepare for the next break
+        Simulation::GetInstance().ResetTable();
+
+        // Replays must run alongside framerate
+    } while (!Simulation::GetInstance().IsReplay() && watch.Elapsed() < budget);
 
-    // Prepare for the next break
-    Simulation::GetInstance().BeforeReset();
-    RP_GET_INSTANCE(RPBilMain)->Reset();
-    Simulation::GetInstance().AfterReset();
+    // Decide whether to draw this frame
+    Headless::GetInstance().Calculate();
 }
 KM_BRANCH_MF(0x802ba1e0, BilScene, CalculateEx);
 
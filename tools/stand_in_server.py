@@ -0,0 +1,101 @@
+from argparse import ArgumentParser
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from json import dumps
+from time import time
+from urllib.parse import parse_qs, urlparse
+
+
+class LeaseTable:
+    """Hands out blocks of each style's parameter space"""
+
+    def __init__(self, block_size, timeout):
+        self.block_size = block_size
+        self.timeout = timeout
+        self.next_id = 0
+        self.next_start = {}  # style -> next unleased index
+        self.leases = {}  # id -> (style, start, expire time)
+        self.expired = []  # (style, start) returned by expired leases
+
+    def lease(self, style):
+        now = time()
+
+        # Leases that were never reported go back into the pool
+        for lease_id, (s, start, expire) in list(self.leases.items()):
+            if now >= expire:
+                del self.leases[lease_id]
+                self.expired.append((s, start))
+
+        start = None
+        for i, (s, st) in enumerate(self.expired):
+            if s == style:
+                start = st
+                del self.expired[i]
+                break
+
+        if start is None:
+            start = self.next_start.get(style, 0)
+            self.next_start[style] = start + self.block_size
+
+        lease_id = self.next_id
+        self.next_id += 1
+        self.leases[lease_id] = (style, start, now + self.timeout)
+
+        return {"id": lease_id, "start": start, "count": self.block_size,
+                "timeout": self.timeout}
+
+    def report(self, lease_id):
+        return self.leases.pop(lease_id, None) is not None
+
+
+def make_handler(table):
+    class Handler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            url = urlparse(self.path)
+            if url.path != "/billiards/api":
+                self.send_error(404)
+                return
+
+            params = {k: v[0] for k, v in parse_qs(url.query).items()}
+            action = params.get("action")
+
+            if action == "lease":
+                body = dumps(table.lease(int(params.get("style", 0))))
+                print(f"[LEASE] {body}")
+            elif action == "report":
+                ok = table.report(int(params.get("lease", -1)))
+                print(f"[REPORT] {params} {'ok' if ok else 'unknown lease'}")
+                body = "{}"
+            else:
+                # Individual break upload
+                print(f"[BREAK] {params}")
+                body = "{}"
+
+            data = body.encode()
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+
+    return Handler
+
+
+def main():
+    parser = ArgumentParser(
+        description="Local stand-in for the submission server")
+    parser.add_argument("--port", type=int, default=80,
+                        help="Listening port")
+    parser.add_argument("--block", type=int, default=4096,
+                        help="Sequence indices per lease")
+    parser.add_argument("--timeout", type=int, default=3600,
+                        help="Seconds before an unreported lease is reissued")
+    args = parser.parse_args()
+
+    table = LeaseTable(args.block, args.timeout)
+    server = HTTPServer(("", args.port), make_handler(table))
+    print(f"Listening on port {args.port}")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()